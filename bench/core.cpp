@@ -0,0 +1,120 @@
+#include <fixtures.hpp>
+#include <ini.hpp>
+#include <playlist.hpp>
+#include <suites.hpp>
+#include <tracklist.hpp>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace riff::bench {
+namespace {
+namespace fs = std::filesystem;
+
+[[nodiscard]] auto make_paths(std::size_t const count) {
+	auto ret = std::vector<std::string>{};
+	ret.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		ret.push_back(std::format("/music/artist_{:03}/album_{:03}/track_{:06}.flac", i % 997, i % 331, i));
+	}
+	return ret;
+}
+
+[[nodiscard]] auto temp_path(std::string_view const filename) {
+	auto const dir = fs::temp_directory_path() / "riff-bench";
+	fs::create_directories(dir);
+	return (dir / filename).generic_string();
+}
+
+// Tracklist::push sniffs each file: count paths cycling over the valid fixtures written to directory.
+[[nodiscard]] auto make_fixture_paths(fs::path const& directory, std::size_t const count) {
+	auto files = std::vector<std::string>{};
+	for (auto const& written : fixtures::write_all(directory, fixtures::Signal{.duration = 0.5f})) {
+		if (written.valid) { files.push_back(written.path.generic_string()); }
+	}
+	auto ret = std::vector<std::string>{};
+	if (files.empty()) { return ret; }
+	ret.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) { ret.push_back(files.at(i % files.size())); }
+	return ret;
+}
+
+void tracklist_push(Runner& runner, fs::path const& directory) {
+	static constexpr auto count_v = std::size_t{100'000};
+	auto const paths = make_fixture_paths(directory, count_v);
+	runner.run("tracklist/push/100k", count_v, [] { return std::make_unique<Tracklist>(); },
+			   [&](std::unique_ptr<Tracklist>& tracklist) { tracklist->push(paths); });
+	runner.run("tracklist/push_track/100k", count_v, [] { return std::make_unique<Tracklist>(); },
+			   [&](std::unique_ptr<Tracklist>& tracklist) {
+				   for (auto const& path : paths) { tracklist->push_track(Track{.path = path, .name = path}); }
+			   });
+}
+
+void playlist_io(Runner& runner) {
+	static constexpr auto count_v = std::size_t{500'000};
+	auto const path = temp_path("bench.m3u");
+	auto playlist = Playlist{.paths = make_paths(count_v)};
+
+	runner.run("playlist/save/500k", count_v, [&] { [[maybe_unused]] auto const res = playlist.save_to(path); });
+	if (!fs::exists(path)) { [[maybe_unused]] auto const res = playlist.save_to(path); }
+	runner.run("playlist/parse/500k", count_v, [] { return Playlist{}; },
+			   [&](Playlist& out) { out.append_from(path); });
+	fs::remove(path);
+}
+
+// mirrors Playback::cycle: keep cycling while any track is playable, until a non-error track is reached
+void cycle_errors(Runner& runner, fs::path const& directory, std::size_t const run_length) {
+	static constexpr auto tracks_v = std::size_t{20'000};
+	static constexpr auto hops_v = 10;
+	auto tracklist = Tracklist{};
+	tracklist.push(make_fixture_paths(directory, tracks_v));
+	auto index = std::size_t{};
+	tracklist.for_each_track([&](Track& track) {
+		track.status = (index++ % (run_length + 1)) == run_length ? Track::Status::Ok : Track::Status::Error;
+	});
+
+	auto const name = std::format("tracklist/cycle_next/error_run_{}", run_length);
+	runner.run(name, hops_v * (run_length + 1), [&] {
+		for (int hop = 0; hop < hops_v; ++hop) {
+			while (tracklist.has_playable_track()) {
+				auto const* track = tracklist.cycle_next();
+				if (track == nullptr || track->status != Track::Status::Error) { break; }
+			}
+		}
+	});
+}
+
+void ini_io(Runner& runner, std::size_t const keys) {
+	auto const path = temp_path(std::format("bench_{}.conf", keys));
+	auto ini = Ini{};
+	auto names = std::vector<std::pair<std::string, std::string>>{};
+	names.reserve(keys);
+	for (std::size_t i = 0; i < keys; ++i) {
+		auto const& [section, key] = names.emplace_back(std::format("section_{}", i % 16), std::format("key_{}", i));
+		ini.set_value({section, key}, std::format("{}", i));
+	}
+
+	runner.run(std::format("ini/save/{}", keys), keys, [&] { [[maybe_unused]] auto const res = ini.save(path.c_str()); });
+	if (!fs::exists(path)) { [[maybe_unused]] auto const res = ini.save(path.c_str()); }
+	runner.run(std::format("ini/load/{}", keys), keys, [] { return Ini{}; },
+			   [&](Ini& out) { [[maybe_unused]] auto const res = out.load(path.c_str()); });
+	runner.run(std::format("ini/get/{}", keys), keys, [&] {
+		auto found = std::size_t{};
+		for (auto const& [section, key] : names) { found += ini.get_value({section, key}).size(); }
+		return found;
+	});
+	fs::remove(path);
+}
+} // namespace
+
+void run_core(Runner& runner) {
+	auto const directory = fs::path{temp_path("fixtures")};
+	tracklist_push(runner, directory);
+	playlist_io(runner);
+	for (auto const run_length : {10uz, 100uz, 1000uz}) { cycle_errors(runner, directory, run_length); }
+	fs::remove_all(directory);
+	for (auto const keys : {100uz, 10'000uz}) { ini_io(runner, keys); }
+}
+} // namespace riff::bench
@@ -0,0 +1,39 @@
+#include <capo/buffer.hpp>
+#include <fixtures.hpp>
+#include <suites.hpp>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace riff::bench {
+namespace {
+namespace fs = std::filesystem;
+
+void decode(Runner& runner, fixtures::Format const format) {
+	auto const signal = fixtures::Signal{.duration = 30.0f};
+	auto const extension = fixtures::get_extension(format);
+	auto const name = std::format("decode/{}/30s", extension.substr(1));
+	if (!runner.is_selected(name)) { return; }
+
+	auto const dir = fs::temp_directory_path() / "riff-bench";
+	fs::create_directories(dir);
+	auto const path = (dir / std::format("decode{}", extension)).generic_string();
+	{
+		auto const bytes = fixtures::encode(format, signal);
+		auto file = std::ofstream{path, std::ios::binary};
+		file.write(reinterpret_cast<char const*>(bytes.data()), std::streamsize(bytes.size())); // NOLINT
+	}
+
+	auto const frames = std::size_t(signal.duration * float(signal.sample_rate));
+	runner.run(name, frames, [] { return capo::Buffer{}; },
+			   [&](capo::Buffer& buffer) { [[maybe_unused]] auto const res = buffer.decode_file(path.c_str()); });
+	fs::remove(path);
+}
+} // namespace
+
+void run_decode(Runner& runner) {
+	for (auto const format : {fixtures::Format::Wav, fixtures::Format::Flac, fixtures::Format::Mp3}) {
+		decode(runner, format);
+	}
+}
+} // namespace riff::bench
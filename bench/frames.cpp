@@ -0,0 +1,193 @@
+#include <capo/engine.hpp>
+#include <fixtures.hpp>
+#include <imgui.h>
+#include <playback.hpp>
+#include <suites.hpp>
+#include <array>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <print>
+
+namespace riff::bench {
+namespace {
+namespace fs = std::filesystem;
+
+// scripted mouse input over the tracklist area: wheel scrolling, clicks and double clicks on a fixed cycle.
+struct InputScript {
+	static constexpr auto period_v = 120;
+	static constexpr auto target_v = ImVec2{200.0f, 400.0f};
+
+	static void apply(ImGuiIO& io, int const frame) {
+		auto const phase = frame % period_v;
+		io.AddMousePosEvent(target_v.x, target_v.y + float(phase % 10) * 4.0f);
+		io.AddMouseWheelEvent(0.0f, phase < period_v / 2 ? -1.0f : 1.0f);
+		switch (phase % 30) {
+		case 0: // click
+		case 20: // double click: down/up/down/up over consecutive frames
+		case 22: io.AddMouseButtonEvent(ImGuiMouseButton_Left, true); break;
+		case 1:
+		case 21:
+		case 23: io.AddMouseButtonEvent(ImGuiMouseButton_Left, false); break;
+		default: break;
+		}
+	}
+};
+
+// ImGui context without a platform or renderer backend: frames are built and rendered to draw lists only.
+class NullContext {
+  public:
+	NullContext(NullContext const&) = delete;
+	NullContext(NullContext&&) = delete;
+	auto operator=(NullContext const&) = delete;
+	auto operator=(NullContext&&) = delete;
+
+	NullContext() {
+		ImGui::CreateContext();
+		auto& io = ImGui::GetIO();
+		io.IniFilename = nullptr;
+		io.DisplaySize = ImVec2{1280.0f, 720.0f};
+		io.DeltaTime = 1.0f / 60.0f;
+		io.Fonts->Build();
+	}
+
+	~NullContext() { ImGui::DestroyContext(); }
+
+	template <typename F>
+	void frame(F func) {
+		InputScript::apply(ImGui::GetIO(), m_frame++);
+		ImGui::NewFrame();
+		ImGui::SetNextWindowPos({});
+		ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+		if (ImGui::Begin("main")) { func(); }
+		ImGui::End();
+		ImGui::Render();
+	}
+
+  private:
+	int m_frame{};
+};
+
+struct NullMediator : Tracklist::IMediator, Player::IMediator {
+	auto play_track(Track& /*track*/) -> bool final { return true; }
+	void unload_active() final {}
+	void on_save() final {}
+	auto draw_cover(Track const& /*track*/, float /*size*/) -> bool final { return false; }
+
+	void skip_prev() final {}
+	void skip_next() final {}
+	void open_library() final {}
+	auto draw_active_cover(float /*size*/) -> bool final { return false; }
+};
+
+// forwards to Playback like App does.
+struct AppMediator : Tracklist::IMediator, Player::IMediator {
+	explicit AppMediator(Playback& playback) : playback(&playback) {}
+
+	auto play_track(Track& track) -> bool final { return playback->play_track(track); }
+	void unload_active() final { playback->unload_active(); }
+	void on_save() final {}
+	auto draw_cover(Track const& /*track*/, float /*size*/) -> bool final { return false; }
+
+	void skip_prev() final { playback->skip_prev(); }
+	void skip_next() final { playback->skip_next(); }
+	void open_library() final {}
+	auto draw_active_cover(float /*size*/) -> bool final { return false; }
+
+	Playback* playback;
+};
+
+// a short WAV fixture on disk, removed on destruction.
+class TempTrack {
+  public:
+	TempTrack(TempTrack const&) = delete;
+	TempTrack(TempTrack&&) = delete;
+	auto operator=(TempTrack const&) = delete;
+	auto operator=(TempTrack&&) = delete;
+
+	TempTrack() {
+		auto const dir = fs::temp_directory_path() / "riff-bench";
+		fs::create_directories(dir);
+		m_path = (dir / "frames.wav").generic_string();
+		auto const bytes = fixtures::encode(fixtures::Format::Wav, fixtures::Signal{.duration = 2.0f});
+		auto file = std::ofstream{m_path, std::ios::binary};
+		file.write(reinterpret_cast<char const*>(bytes.data()), std::streamsize(bytes.size())); // NOLINT
+	}
+
+	~TempTrack() { fs::remove(m_path); }
+
+	[[nodiscard]] auto get_path() const -> std::string_view { return m_path; }
+
+  private:
+	std::string m_path{};
+};
+
+void fill(Tracklist& tracklist, std::size_t const tracks, std::string_view const path) {
+	auto const name = std::string{path.substr(path.find_last_of('/') + 1)};
+	for (std::size_t i = 0; i < tracks; ++i) { tracklist.push_track(Track{.path = std::string{path}, .name = name}); }
+	tracklist.for_each_track([](Track& track) { track.status = Track::Status::Ok; });
+}
+
+void setup(Player& player) {
+	player.set_volume(0);
+	player.set_show_meters(true);
+}
+
+void tracklist_frame(Runner& runner, std::size_t const tracks) {
+	auto const name = std::format("tracklist/frame/{}", tracks);
+	if (!runner.is_selected(name)) { return; }
+	auto context = NullContext{};
+	auto mediator = NullMediator{};
+	auto tracklist = Tracklist{};
+	fill(tracklist, tracks, "/music/track.wav");
+	runner.sample(name, tracks, [&](int /*frame*/) { context.frame([&] { tracklist.update(mediator); }); });
+}
+
+void player_frame(Runner& runner, capo::IEngine& engine, TempTrack const& temp) {
+	static constexpr std::string_view name_v{"player/frame"};
+	if (!runner.is_selected(name_v)) { return; }
+	auto source = engine.create_source();
+	if (!source) { return; }
+	auto player = Player{std::move(source)};
+	setup(player);
+	auto track = Track{.path = std::string{temp.get_path()}, .name = "frames"};
+	player.load_track(track);
+	auto context = NullContext{};
+	auto mediator = NullMediator{};
+	runner.sample(name_v, 1, [&](int /*frame*/) { context.frame([&] { player.update(mediator); }); });
+}
+
+// the main window body of App::update(), through the same Playback::update_frame.
+void app_frame(Runner& runner, capo::IEngine& engine, TempTrack const& temp, std::size_t const tracks) {
+	auto const name = std::format("app/frame/{}", tracks);
+	if (!runner.is_selected(name)) { return; }
+	auto source = engine.create_source();
+	if (!source) { return; }
+	auto player = Player{std::move(source)};
+	setup(player);
+	auto tracklist = Tracklist{};
+	fill(tracklist, tracks, temp.get_path());
+	auto playback = Playback{player, tracklist};
+	auto context = NullContext{};
+	auto mediator = AppMediator{playback};
+	runner.sample(name, tracks, [&](int /*frame*/) {
+		context.frame([&] { playback.update_frame(mediator, mediator); });
+	});
+	player.unload_track();
+}
+} // namespace
+
+void run_frames(Runner& runner) {
+	static constexpr auto counts_v = std::array{10'000uz, 100'000uz, 1'000'000uz};
+	for (auto const tracks : counts_v) { tracklist_frame(runner, tracks); }
+
+	auto engine = capo::create_engine();
+	if (!engine) {
+		std::println("no audio engine, skipping player/app frames");
+		return;
+	}
+	auto const temp = TempTrack{};
+	player_frame(runner, *engine, temp);
+	for (auto const tracks : counts_v) { app_frame(runner, *engine, temp, tracks); }
+}
+} // namespace riff::bench
@@ -0,0 +1,45 @@
+#include <build_version.hpp>
+#include <klib/args/parse.hpp>
+#include <suites.hpp>
+#include <array>
+#include <fstream>
+#include <print>
+
+auto main(int argc, char** argv) -> int {
+	try {
+		auto info = riff::bench::Runner::Info{};
+		auto json_path = std::string_view{};
+		auto const app_info = klib::args::ParseInfo{
+			.help_text = "riff-bench: benchmarks for riff hot paths",
+			.version = riff::build_version_str,
+		};
+		auto const args = std::array{
+			klib::args::named_option(info.filter, "filter", "only run benchmarks whose name contains this"),
+			klib::args::named_option(info.repetitions, "repetitions", "timed repetitions per benchmark"),
+			klib::args::named_option(info.frames, "frames", "timed frames per UI benchmark"),
+			klib::args::named_option(json_path, "json", "write results as JSON to this path"),
+		};
+		auto const parse_result = klib::args::parse_main(app_info, args, argc, argv);
+		if (parse_result.early_return()) { return parse_result.get_return_code(); }
+
+		auto runner = riff::bench::Runner{info};
+		riff::bench::run_core(runner);
+		riff::bench::run_frames(runner);
+		riff::bench::run_decode(runner);
+
+		if (!json_path.empty()) {
+			auto file = std::ofstream{std::string{json_path}};
+			if (!file.is_open()) {
+				std::println("failed to open: {}", json_path);
+				return EXIT_FAILURE;
+			}
+			file << runner.to_json();
+		}
+	} catch (std::exception const& e) {
+		std::println("PANIC: {}", e.what());
+		return EXIT_FAILURE;
+	} catch (...) {
+		std::println("PANIC!");
+		return EXIT_FAILURE;
+	}
+}
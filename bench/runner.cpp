@@ -0,0 +1,53 @@
+#include <build_version.hpp>
+#include <runner.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <print>
+
+namespace riff::bench {
+auto Result::min() const -> double { return samples.empty() ? 0.0 : std::ranges::min(samples); }
+
+auto Result::max() const -> double { return samples.empty() ? 0.0 : std::ranges::max(samples); }
+
+auto Result::mean() const -> double {
+	if (samples.empty()) { return 0.0; }
+	return std::accumulate(samples.begin(), samples.end(), 0.0) / double(samples.size());
+}
+
+auto Result::percentile(double const p) const -> double {
+	if (samples.empty()) { return 0.0; }
+	auto sorted = samples;
+	std::ranges::sort(sorted);
+	auto const index = std::size_t(std::ceil(p * double(sorted.size()))) - 1;
+	return sorted.at(std::min(index, sorted.size() - 1));
+}
+
+auto Runner::is_selected(std::string_view const name) const -> bool {
+	return m_info.filter.empty() || name.contains(m_info.filter);
+}
+
+auto Runner::to_json() const -> std::string {
+	auto ret = std::string{};
+	auto out = std::back_inserter(ret);
+	std::format_to(out, "{{\n  \"version\": \"{}\",\n  \"unit\": \"ms\",\n  \"benchmarks\": [", build_version_str);
+	auto first = true;
+	for (auto const& result : m_results) {
+		std::format_to(out, "{}\n    {{\"name\": \"{}\", \"items\": {}, \"repetitions\": {}, ", first ? "" : ",",
+					   result.name, result.items, result.samples.size());
+		std::format_to(out, "\"min\": {:.4f}, \"p50\": {:.4f}, \"p99\": {:.4f}, \"mean\": {:.4f}, \"max\": {:.4f}}}",
+					   result.min(), result.percentile(0.5), result.percentile(0.99), result.mean(), result.max());
+		first = false;
+	}
+	ret += "\n  ]\n}\n";
+	return ret;
+}
+
+void Runner::push(Result result) {
+	auto const p50 = result.percentile(0.5);
+	auto const per_item = result.items > 0 ? p50 * 1e6 / double(result.items) : 0.0;
+	std::println("{:<40} p50 {:>10.3f} ms  p99 {:>10.3f} ms  min {:>10.3f} ms  ({:.1f} ns/item)", result.name, p50,
+				 result.percentile(0.99), result.min(), per_item);
+	m_results.push_back(std::move(result));
+}
+} // namespace riff::bench
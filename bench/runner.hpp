@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <concepts>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace riff::bench {
+struct Result {
+	std::string name{};
+	std::size_t items{};
+	std::vector<double> samples{}; // milliseconds per repetition
+
+	[[nodiscard]] auto min() const -> double;
+	[[nodiscard]] auto max() const -> double;
+	[[nodiscard]] auto mean() const -> double;
+	[[nodiscard]] auto percentile(double p) const -> double;
+};
+
+class Runner {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Info {
+		std::string_view filter{};
+		int repetitions{10};
+		int frames{300};
+	};
+
+	explicit Runner(Info const& info) : m_info(info) {}
+
+	[[nodiscard]] auto is_selected(std::string_view name) const -> bool;
+
+	// one untimed warmup, then info.repetitions timed runs of func(state), with a fresh setup() each time
+	template <typename Setup, typename F>
+		requires(std::invocable<F, std::invoke_result_t<Setup>&>)
+	void run(std::string_view const name, std::size_t const items, Setup setup, F func) {
+		if (!is_selected(name)) { return; }
+		auto result = Result{.name = std::string{name}, .items = items};
+		for (int i = -1; i < m_info.repetitions; ++i) {
+			auto state = setup();
+			auto const start = Clock::now();
+			func(state);
+			auto const elapsed = std::chrono::duration<double, std::milli>{Clock::now() - start};
+			if (i >= 0) { result.samples.push_back(elapsed.count()); }
+		}
+		push(std::move(result));
+	}
+
+	template <std::invocable F>
+	void run(std::string_view const name, std::size_t const items, F func) {
+		run(name, items, [] { return 0; }, [&func](int /*state*/) { func(); });
+	}
+
+	// one untimed warmup, then info.frames timed calls of func(index), each recorded as a sample
+	template <std::invocable<int> F>
+	void sample(std::string_view const name, std::size_t const items, F func) {
+		if (!is_selected(name)) { return; }
+		auto result = Result{.name = std::string{name}, .items = items};
+		func(-1);
+		for (int i = 0; i < m_info.frames; ++i) {
+			auto const start = Clock::now();
+			func(i);
+			auto const elapsed = std::chrono::duration<double, std::milli>{Clock::now() - start};
+			result.samples.push_back(elapsed.count());
+		}
+		push(std::move(result));
+	}
+
+	[[nodiscard]] auto get_results() const -> std::span<Result const> { return m_results; }
+	[[nodiscard]] auto to_json() const -> std::string;
+
+  private:
+	void push(Result result);
+
+	Info m_info{};
+	std::vector<Result> m_results{};
+};
+} // namespace riff::bench
@@ -0,0 +1,8 @@
+#pragma once
+#include <runner.hpp>
+
+namespace riff::bench {
+void run_core(Runner& runner);
+void run_frames(Runner& runner);
+void run_decode(Runner& runner);
+} // namespace riff::bench
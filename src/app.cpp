@@ -3,11 +3,16 @@
 #include <build_version.hpp>
 #include <embedded.hpp>
 #include <log.hpp>
+#include <algorithm>
 #include <array>
+#include <filesystem>
+#include <unordered_set>
 #include <utility>
 
 namespace riff {
 namespace {
+namespace fs = std::filesystem;
+
 [[nodiscard]] auto self(GLFWwindow* window) -> App& { return *static_cast<App*>(glfwGetWindowUserPointer(window)); }
 
 struct ImFontLoader {
@@ -38,8 +43,15 @@ struct ImFontLoader {
 void App::pre_init() {
 	m_config.path = m_params.config_path;
 	m_config.load_or_create();
+	m_config.watch();
+	m_failures.path = (fs::path{m_config.path}.parent_path() / "riff.failures").generic_string();
+	m_failures.load();
+	m_loudness_scanner.path = (fs::path{m_config.path}.parent_path() / "riff.loudness").generic_string();
+	m_loudness_scanner.load();
 	create_engine();
 	create_player();
+	load_library();
+	m_cover_scanner.directory = (fs::path{m_config.path}.parent_path() / "riff-covers").generic_string();
 
 	m_save_playlist.path.set_text("playlist.m3u");
 }
@@ -79,52 +91,54 @@ void App::update() {
 	ImGui::SetNextWindowSize(viewport.WorkSize);
 	static constexpr auto flags_v =
 		ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar;
-	if (ImGui::Begin("main", nullptr, flags_v)) {
-		if (m_playing && m_player->at_end()) { advance(); }
-		m_player->update(*this);
-		m_playing = m_player->is_playing();
-
-		ImGui::Separator();
-		ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 5.0f);
-		m_tracklist.update(*this);
-	}
+	RIFF_PROFILE_FRAME();
+	if (m_config.poll_reload()) { apply_config(); }
+	update_replay_gain();
+	update_tags();
+	update_covers();
+	update_media();
+	if (ImGui::Begin("main", nullptr, flags_v)) { m_playback->update_frame(*this, *this); }
 	if (m_save_playlist.update()) { save_playlist(m_save_playlist.path.as_view()); }
+	if (m_library_popup.update(m_config, m_library)) { add_library_tracks(); }
 	ImGui::End();
 
+	if (ImGui::IsKeyPressed(ImGuiKey_F3, false)) { m_show_profiler = !m_show_profiler; }
+	if (m_show_profiler) { Profiler::self().update(m_show_profiler); }
+
 	update_config();
 }
 
 auto App::play_track(Track& track) -> bool {
-	if (!load_track(track)) { return false; }
-	if (!m_player->is_playing()) {
-		m_player->play();
-		m_playing = m_player->is_playing();
-	}
-	return true;
+	RIFF_PROFILE_LOAD(PlayTrack);
+	return m_playback->play_track(track);
 }
 
-void App::unload_active() {
-	m_player->unload_track();
-	m_playing = false;
-}
+void App::unload_active() { m_playback->unload_active(); }
 
-void App::skip_prev() {
-	auto const is_playing = m_player->is_playing();
-	if (is_playing && m_player->get_cursor() > 3s) {
-		m_player->set_cursor(0s);
-		return;
+void App::skip_prev() { m_playback->skip_prev(); }
+
+void App::skip_next() { m_playback->skip_next(); }
+
+void App::on_save() { ImGui::OpenPopup(SavePlaylist::label_v.c_str()); }
+
+auto App::draw_cover(Track const& track, float const size) -> bool {
+	if (!CoverTexture::supported_v) { return false; }
+	if (auto const region = m_cover_atlas.find(track.path)) {
+		m_cover_texture.draw(*region, size);
+		return true;
 	}
-	if (!cycle([this] { return m_tracklist.cycle_prev(); })) { return; }
-	if (is_playing && !m_player->is_playing()) { m_player->play(); }
+	if (m_covers_requested.insert(track.path).second) { m_cover_scanner.enqueue(track.path); }
+	ImGui::Dummy({size, size});
+	return true;
 }
 
-void App::skip_next() {
-	auto const is_playing = m_player->is_playing();
-	cycle([this] { return m_tracklist.cycle_next(); });
-	if (is_playing && !m_player->is_playing()) { m_player->play(); }
+auto App::draw_active_cover(float const size) -> bool {
+	auto const* active = m_tracklist.get_active();
+	if (active == nullptr) { return false; }
+	return draw_cover(*active, size);
 }
 
-void App::on_save() { ImGui::OpenPopup(SavePlaylist::label_v.c_str()); }
+void App::open_library() { ImGui::OpenPopup(LibraryPopup::label_v.c_str()); }
 
 void App::create_engine() {
 	m_engine = capo::create_engine();
@@ -136,67 +150,248 @@ void App::create_player() {
 	if (!source) { throw std::runtime_error{"Failed to create Audio Source"}; }
 
 	m_player.emplace(std::move(source));
+	apply_config();
+	m_playback.emplace(*m_player, m_tracklist, &m_failures);
+}
+
+void App::apply_config() {
 	m_player->set_volume(m_config.get_volume());
 	m_player->set_balance(m_config.get_balance());
 	m_player->set_repeat(m_config.get_repeat());
+	m_player->set_normalize(m_config.get_normalize());
+	m_player->set_show_meters(m_config.get_show_meters());
+	m_player->set_show_spectrum(m_config.get_show_spectrum());
 }
 
 void App::update_config() {
 	m_config.set_volume(m_player->get_volume());
 	m_config.set_balance(m_player->get_balance());
 	m_config.set_repeat(m_player->get_repeat());
+	m_config.set_normalize(m_player->get_normalize());
+	m_config.set_show_meters(m_player->get_show_meters());
+	m_config.set_show_spectrum(m_player->get_show_spectrum());
 	m_config.update();
 }
 
-void App::save_playlist(std::string_view const path) {
-	if (m_tracklist.save_playlist(path)) {
-		log.info("playlist saved to: {}", path);
-		return;
+void App::update_replay_gain() {
+	m_loudness_results.clear();
+	m_loudness_scanner.drain_to(m_loudness_results);
+	if (m_loudness_results.empty()) { return; }
+	m_replay_gains.clear();
+	for (auto const& result : m_loudness_results) {
+		for (auto const& track : result.tracks) {
+			m_replay_gains.emplace_back(track.path, ReplayGain{.track_db = track.track_db, .album_db = result.album_db});
+		}
 	}
+	// later results supersede earlier ones for the same path
+	std::ranges::stable_sort(m_replay_gains, {}, &std::pair<std::string, ReplayGain>::first);
+	m_tracklist.for_each_track([&](Track& track) {
+		auto it = std::ranges::upper_bound(m_replay_gains, track.path, {}, &std::pair<std::string, ReplayGain>::first);
+		if (it == m_replay_gains.begin() || (--it)->first != track.path) { return; }
+		track.replay_gain = it->second;
+	});
+	if (auto const* active = m_tracklist.get_active()) { m_player->set_replay_gain(active->replay_gain); }
+}
 
-	log.warn("failed to save playlist to: {}", path);
+void App::scan_loudness() {
+	if (m_player->get_normalize() == Normalize::Off) { return; }
+	m_tracklist.for_each_track([this](Track const& track) {
+		if (!track.replay_gain && track.status != Track::Status::Error) { m_loudness_scanner.enqueue(track.path); }
+	});
+}
+
+// new tracks that failed to decode in an earlier session (and have not changed since) start out as errors
+void App::mark_failures() {
+	if (m_failures.get_size() == 0) { return; }
+	m_tracklist.for_each_track([this](Track& track) {
+		if (track.status != Track::Status::None) { return; }
+		if (m_failures.contains(track.path, {.size = track.size, .mtime = track.mtime})) {
+			track.status = Track::Status::Error;
+		}
+	});
 }
 
-template <typename F>
-auto App::cycle(F get_track) -> bool {
-	return cycle([this] { return m_tracklist.has_playable_track(); }, get_track);
+void App::update_tags() {
+	m_tag_results.clear();
+	m_tag_scanner.drain_to(m_tag_results);
+	if (m_tag_results.empty()) { return; }
+	std::ranges::sort(m_tag_results, {}, &TagScanner::Result::path);
+	auto const* active = m_tracklist.get_active();
+	m_tracklist.for_each_track([&](Track& track) {
+		auto const it = std::ranges::lower_bound(m_tag_results, track.path, {}, &TagScanner::Result::path);
+		if (it == m_tag_results.end() || it->path != track.path) { return; }
+		Tracklist::set_tags(track, it->tags);
+		if (&track == active) { m_player->set_title(track.name); }
+	});
 }
 
-template <typename Pred, typename F>
-auto App::cycle(Pred pred, F get_track) -> bool {
-	while (pred()) {
-		auto* track = get_track();
-		if (track == nullptr) { return false; }
-		if (load_track(*track)) { return true; }
+void App::scan_tags() {
+	m_tracklist.for_each_track([this](Track const& track) {
+		if (!track.tags) { m_tag_scanner.enqueue(track.path); }
+	});
+}
+
+void App::update_covers() {
+	m_cover_atlas.next_frame();
+	m_cover_results.clear();
+	m_cover_scanner.drain_to(m_cover_results);
+	for (auto const& result : m_cover_results) {
+		if (result.thumbnail.is_empty()) { continue; }
+		m_cover_atlas.insert(result.path, result.thumbnail);
+		m_covers_requested.erase(result.path);
 	}
-	return false;
+	m_cover_texture.update(m_cover_atlas);
+}
+
+void App::update_media() {
+	watch_media();
+	m_media_events.clear();
+	m_media_watcher.drain_to(m_media_events);
+	if (m_media_events.empty()) { return; }
+	m_library.update(m_media_events);
+	apply_media_events();
 }
 
-void App::advance() {
-	auto const pred = [this] {
-		return (m_player->get_repeat() == Repeat::All || m_tracklist.has_next_track()) &&
-			   m_tracklist.has_playable_track();
+// library directories come pre-built from its worker; only changes to the watched set reach the watcher
+void App::watch_media() {
+	auto library_directories = m_library.get_directories();
+	auto const tracks = m_tracklist.get_size();
+	if (library_directories == m_library_directories && tracks == m_watched_tracks) { return; }
+	m_library_directories = std::move(library_directories);
+	if (tracks != m_watched_tracks) {
+		m_watched_tracks = tracks;
+		m_track_directories.clear();
+		m_tracklist.for_each_track([this](Track const& track) {
+			m_track_directories.emplace(std::string_view{track.path}.substr(0, track.path.find_last_of('/')));
+		});
+	}
+
+	auto directories = std::vector<std::string>{};
+	directories.reserve(m_library_directories->size() + m_track_directories.size());
+	std::ranges::set_union(*m_library_directories, m_track_directories, std::back_inserter(directories));
+	for (auto const& root : m_config.get_library_roots()) {
+		auto const it = std::ranges::lower_bound(directories, root);
+		if (it == directories.end() || *it != root) { directories.insert(it, root); }
+	}
+
+	auto removed = std::vector<std::string>{};
+	std::ranges::set_difference(m_watched_directories, directories, std::back_inserter(removed));
+	for (auto const& directory : removed) { m_media_watcher.unwatch(directory); }
+	auto added = std::vector<std::string>{};
+	std::ranges::set_difference(directories, m_watched_directories, std::back_inserter(added));
+	for (auto const& directory : added) {
+		if (!m_media_watcher.watch(directory)) { log.warn("failed to watch directory: {}", directory); }
+	}
+	m_watched_directories = std::move(directories);
+}
+
+// removed tracks are relocated if a file with the same name appeared in the same batch, else marked as errors.
+// modified tracks have their tags, loudness and cover read again.
+void App::apply_media_events() {
+	using Event = FileWatcher::Event;
+	std::ranges::sort(m_media_events, {}, &Event::path);
+	auto const find_event = [this](std::string_view const path) -> Event const* {
+		auto const it = std::ranges::lower_bound(m_media_events, path, {}, &Event::path);
+		return it != m_media_events.end() && it->path == path ? &*it : nullptr;
+	};
+	auto const get_filename = [](std::string_view const path) { return path.substr(path.find_last_of('/') + 1); };
+	auto const find_moved = [&](std::string_view const path) -> std::string const* {
+		for (auto const& event : m_media_events) {
+			if (event.kind != FileWatcher::Kind::Changed || get_filename(event.path) != get_filename(path)) { continue; }
+			if (fs::is_regular_file(event.path)) { return &event.path; }
+		}
+		return nullptr;
 	};
-	if (!cycle(pred, [this] { return m_tracklist.cycle_next(); })) { return; }
-	m_player->play();
+
+	auto modified = false;
+	m_tracklist.for_each_track([&](Track& track) {
+		auto const directory = std::string_view{track.path}.substr(0, track.path.find_last_of('/'));
+		if (find_event(track.path) == nullptr && find_event(directory) == nullptr) { return; }
+		if (!fs::exists(track.path)) {
+			auto const* moved = find_moved(track.path);
+			if (moved == nullptr) {
+				track.status = Track::Status::Error;
+				return;
+			}
+			log.info("track moved: {} => {}", track.path, *moved);
+			track.path = *moved;
+		}
+		// an unchanged file that failed to decode stays an error, a missing one that reappeared is retried
+		auto const stamp = FailureCache::get_stamp(track.path);
+		if (stamp == FailureCache::Stamp{.size = track.size, .mtime = track.mtime}) {
+			if (track.status != Track::Status::Error || m_failures.contains(track.path, stamp)) { return; }
+		}
+		track.size = stamp.size;
+		track.mtime = stamp.mtime;
+		if (track.status == Track::Status::Error) { track.status = Track::Status::None; }
+		track.tags.reset();
+		track.replay_gain.reset();
+		m_loudness_scanner.invalidate(track.path);
+		m_cover_atlas.remove(track.path);
+		m_covers_requested.erase(track.path);
+		modified = true;
+	});
+	if (!modified) { return; }
+	scan_tags();
+	scan_loudness();
+}
+
+void App::load_library() {
+	m_library.path = (fs::path{m_config.path}.parent_path() / "riff.library").generic_string();
+	m_library.load();
+	if (!m_config.get_library_roots().empty()) { m_library.rescan(m_config.get_library_roots()); }
+}
+
+void App::add_library_tracks() {
+	auto const index = m_library.get_index();
+	auto const was_empty = m_tracklist.is_empty();
+	// tracks keep their node (and path) while the list grows
+	auto existing = std::unordered_set<std::string_view>{};
+	existing.reserve(m_tracklist.get_size());
+	m_tracklist.for_each_track([&existing](Track const& track) { existing.insert(track.path); });
+	auto count = 0uz;
+	for (auto const& entry : *index) {
+		if (entry.info.format == AudioFormat::Unknown || existing.contains(entry.path)) { continue; }
+		auto track = Track{
+			.path = entry.path,
+			.name = fs::path{entry.path}.filename().generic_string(),
+			.duration = entry.info.duration,
+			.size = entry.size,
+			.mtime = entry.mtime,
+			.tags = entry.tags,
+		};
+		capo::format_duration_to(track.duration_label, track.duration);
+		m_tracklist.push_track(std::move(track));
+		++count;
+	}
+	log.info("added {} library tracks", count);
+	mark_failures();
+	scan_tags();
+	scan_loudness();
+	if (was_empty) { m_playback->advance(); }
 }
 
-auto App::load_track(Track& track) -> bool {
-	if (m_player->load_track(track)) { return true; }
-	log.error("failed to load track: {}", track.path);
-	return false;
+void App::save_playlist(std::string_view const path) {
+	if (m_tracklist.save_playlist(path)) {
+		log.info("playlist saved to: {}", path);
+		return;
+	}
+
+	log.warn("failed to save playlist to: {}", path);
 }
 
 void App::on_drop(std::span<char const* const> paths) {
+	RIFF_PROFILE_ZONE(DropIngest);
 	auto const was_empty = m_tracklist.is_empty();
-	for (auto const* path : paths) {
-		if (!m_tracklist.push(path)) {
-			log.info("skipping non-music file: {}", path);
-			return;
-		}
+	auto const batch = std::vector<std::string>{paths.begin(), paths.end()};
+	if (auto const rejected = m_tracklist.push(batch); rejected > 0) {
+		log.info("skipped {} of {} dropped files: not music or playlists", rejected, batch.size());
 	}
+	mark_failures();
+	scan_tags();
+	scan_loudness();
 	if (!was_empty) { return; }
-	advance();
+	m_playback->advance();
 }
 
 void App::install_callbacks(GLFWwindow* window) {
@@ -223,4 +418,50 @@ auto App::SavePlaylist::update() -> bool {
 	}
 	return ret;
 }
+
+auto App::LibraryPopup::update(Config& config, Library& library) -> bool {
+	if (!imcpp::begin_modal(label_v)) { return false; }
+
+	auto remove = std::string{};
+	for (auto const& path : config.get_library_roots()) {
+		ImGui::PushID(path.c_str());
+		if (ImGui::SmallButton("x")) { remove = path; }
+		ImGui::PopID();
+		ImGui::SameLine();
+		ImGui::TextUnformatted(path.c_str());
+	}
+	auto rescan = false;
+	if (!remove.empty()) {
+		config.remove_library_root(remove);
+		rescan = true;
+	}
+
+	ImGui::SetNextItemWidth(250.0f);
+	root.update("##root");
+	ImGui::SameLine();
+	auto const is_empty = root.as_view().empty();
+	if (is_empty) { ImGui::BeginDisabled(); }
+	if (ImGui::Button("Add Root")) {
+		config.add_library_root(fs::absolute(root.as_view()).generic_string());
+		root.set_text({});
+		rescan = true;
+	}
+	if (is_empty) { ImGui::EndDisabled(); }
+
+	ImGui::Separator();
+	auto const index = library.get_index();
+	if (library.is_scanning()) {
+		ImGui::Text("%zu files (scanning...)", index->size());
+	} else {
+		ImGui::Text("%zu files", index->size());
+	}
+	if (ImGui::Button("Rescan")) { rescan = true; }
+	if (rescan) { library.rescan(config.get_library_roots()); }
+	ImGui::SameLine();
+	auto const ret = ImGui::Button("Add to Tracklist");
+	ImGui::SameLine();
+	if (ret || ImGui::Button("Close")) { ImGui::CloseCurrentPopup(); }
+	ImGui::EndPopup();
+	return ret;
+}
 } // namespace riff
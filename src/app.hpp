@@ -1,16 +1,21 @@
 #pragma once
 #include <capo/engine.hpp>
 #include <config.hpp>
+#include <cover_atlas.hpp>
+#include <cover_scanner.hpp>
+#include <cover_texture.hpp>
+#include <failure_cache.hpp>
 #include <gvdi/app.hpp>
 #include <imcpp.hpp>
-#include <player.hpp>
-#include <tracklist.hpp>
+#include <library.hpp>
+#include <loudness_scanner.hpp>
+#include <params.hpp>
+#include <playback.hpp>
+#include <profiler.hpp>
+#include <set>
+#include <tag_scanner.hpp>
 
 namespace riff {
-struct Params {
-	std::string_view config_path{"riff.conf"};
-};
-
 class App : public gvdi::App, public Tracklist::IMediator, public Player::IMediator {
   public:
 	explicit App(Params const& params) : m_params(params) {}
@@ -24,6 +29,15 @@ class App : public gvdi::App, public Tracklist::IMediator, public Player::IMedia
 		imcpp::InputText path{};
 	};
 
+	struct LibraryPopup {
+		static constexpr auto label_v = klib::CString{"Library"};
+
+		// returns true if the library should be added to the tracklist
+		auto update(Config& config, Library& library) -> bool;
+
+		imcpp::InputText root{};
+	};
+
 	void pre_init() final;
 	auto create_window() -> GLFWwindow* final;
 	void post_init() final;
@@ -35,24 +49,30 @@ class App : public gvdi::App, public Tracklist::IMediator, public Player::IMedia
 	void skip_prev() final;
 	void skip_next() final;
 	void on_save() final;
+	auto draw_cover(Track const& track, float size) -> bool final;
+	auto draw_active_cover(float size) -> bool final;
+	void open_library() final;
 
 	void create_engine();
 	void create_player();
+	void apply_config();
 
 	void on_drop(std::span<char const* const> paths);
 	void update_config();
+	void update_replay_gain();
+	void scan_loudness();
+	void mark_failures();
+	void update_tags();
+	void scan_tags();
+	void update_covers();
+	void update_media();
+	void watch_media();
+	void apply_media_events();
+	void load_library();
+	void add_library_tracks();
 
 	void save_playlist(std::string_view path);
 
-	template <typename F>
-	auto cycle(F get_track) -> bool;
-	template <typename Pred, typename F>
-	auto cycle(Pred pred, F get_track) -> bool;
-
-	void advance();
-
-	auto load_track(Track& track) -> bool;
-
 	static void install_callbacks(GLFWwindow* window);
 
 	Params m_params{};
@@ -61,7 +81,37 @@ class App : public gvdi::App, public Tracklist::IMediator, public Player::IMedia
 	std::optional<Player> m_player{};
 
 	Tracklist m_tracklist{};
-	bool m_playing{};
+	std::optional<Playback> m_playback{};
 	SavePlaylist m_save_playlist{};
+	LibraryPopup m_library_popup{};
+
+	Library m_library{};
+	FailureCache m_failures{};
+
+	LoudnessScanner m_loudness_scanner{};
+	std::vector<LoudnessScanner::Result> m_loudness_results{};
+	// flattened and sorted by path
+	std::vector<std::pair<std::string, ReplayGain>> m_replay_gains{};
+
+	TagScanner m_tag_scanner{};
+	std::vector<TagScanner::Result> m_tag_results{};
+
+	CoverScanner m_cover_scanner{};
+	std::vector<CoverScanner::Result> m_cover_results{};
+	// scanned or in flight, entries are removed when a thumbnail enters the atlas (and may later be evicted)
+	std::set<std::string, std::less<>> m_covers_requested{};
+	CoverAtlas m_cover_atlas{};
+	CoverTexture m_cover_texture{};
+
+	// directories of loaded tracks and library files
+	FileWatcher m_media_watcher{};
+	// sorted
+	std::vector<std::string> m_watched_directories{};
+	std::shared_ptr<Library::Directories const> m_library_directories{};
+	std::set<std::string, std::less<>> m_track_directories{};
+	std::size_t m_watched_tracks{};
+	std::vector<FileWatcher::Event> m_media_events{};
+
+	bool m_show_profiler{};
 };
 } // namespace riff
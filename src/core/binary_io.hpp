@@ -0,0 +1,70 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace riff {
+// little endian fields, strings are prefixed with their 32 bit size.
+class BinaryWriter {
+  public:
+	explicit BinaryWriter(std::string& out) : m_out(out) {}
+
+	template <typename Type>
+		requires(std::is_arithmetic_v<Type>)
+	void write(Type const value) {
+		auto bytes = std::bit_cast<std::array<char, sizeof(Type)>>(value);
+		if constexpr (std::endian::native == std::endian::big) { std::ranges::reverse(bytes); }
+		m_out.append(bytes.data(), bytes.size());
+	}
+
+	void write(std::string_view const str) {
+		write(std::uint32_t(str.size()));
+		m_out.append(str);
+	}
+
+  private:
+	std::string& m_out;
+};
+
+// reads fail (and keep failing) once the input runs out.
+class BinaryReader {
+  public:
+	explicit BinaryReader(std::string_view in) : m_in(in) {}
+
+	[[nodiscard]] auto is_ok() const -> bool { return m_ok; }
+
+	template <typename Type>
+		requires(std::is_arithmetic_v<Type>)
+	auto read(Type& out) -> bool {
+		auto bytes = std::array<char, sizeof(Type)>{};
+		if (!take(bytes.size(), bytes.data())) { return false; }
+		if constexpr (std::endian::native == std::endian::big) { std::ranges::reverse(bytes); }
+		out = std::bit_cast<Type>(bytes);
+		return true;
+	}
+
+	auto read(std::string& out) -> bool {
+		auto size = std::uint32_t{};
+		if (!read(size) || size > m_in.size()) { return m_ok = false; }
+		out.assign(m_in.substr(0, size));
+		m_in.remove_prefix(size);
+		return true;
+	}
+
+  private:
+	auto take(std::size_t const count, char* out) -> bool {
+		if (!m_ok || count > m_in.size()) { return m_ok = false; }
+		std::memcpy(out, m_in.data(), count);
+		m_in.remove_prefix(count);
+		return true;
+	}
+
+	std::string_view m_in;
+	bool m_ok{true};
+};
+} // namespace riff
@@ -0,0 +1,222 @@
+#include <config.hpp>
+#include <ini.hpp>
+#include <klib/enum_array.hpp>
+#include <log.hpp>
+#include <profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr auto repeat_str_v = klib::EnumArray<Repeat, std::string_view>{"none", "one", "all"};
+constexpr auto normalize_str_v = klib::EnumArray<Normalize, std::string_view>{"off", "track", "album"};
+constexpr auto library_section_v = std::string_view{"library"};
+constexpr auto library_root_prefix_v = std::string_view{"root_"};
+
+template <typename E>
+constexpr void from_str(klib::EnumArray<E, std::string_view> const& str, std::string_view const in, E& out) {
+	for (auto e = E{}; e < E::COUNT_; e = E(int(e) + 1)) {
+		if (in == str[e]) {
+			out = e;
+			return;
+		}
+	}
+}
+auto read_text(std::string const& path, std::string& out) -> bool {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return false; }
+	out.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+	return true;
+}
+} // namespace
+
+auto Config::load() -> bool {
+	if (load_silent()) {
+		log.info("loaded config from: {}", path);
+		return true;
+	}
+	log.warn("failed to load config from: {}", path);
+	return false;
+}
+
+auto Config::save() -> bool {
+	if (save_silent()) {
+		log.info("config saved to: {}", path);
+		return true;
+	}
+	log.warn("failed to save config to: {}", path);
+	return false;
+}
+
+auto Config::load_or_create() -> bool {
+	if (load_silent()) {
+		log.info("loaded config from: {}", path);
+		return true;
+	}
+
+	if (save_silent()) {
+		log.info("created config at: {}", path);
+		return true;
+	}
+
+	log.warn("failed to create config at: {}", path);
+	return false;
+}
+
+void Config::set_volume(int const volume) {
+	if (volume == m_volume) { return; }
+	m_volume = volume;
+	m_dirty = true;
+}
+
+void Config::set_balance(float const balance) {
+	if (std::abs(balance - m_balance) < 0.01f) { return; }
+	m_balance = balance;
+	m_dirty = true;
+}
+
+void Config::set_repeat(Repeat const repeat) {
+	if (repeat == m_repeat) { return; }
+	m_repeat = repeat;
+	m_dirty = true;
+}
+
+void Config::set_normalize(Normalize const normalize) {
+	if (normalize == m_normalize) { return; }
+	m_normalize = normalize;
+	m_dirty = true;
+}
+
+void Config::set_show_meters(bool const show) {
+	if (show == m_show_meters) { return; }
+	m_show_meters = show;
+	m_dirty = true;
+}
+
+void Config::set_show_spectrum(bool const show) {
+	if (show == m_show_spectrum) { return; }
+	m_show_spectrum = show;
+	m_dirty = true;
+}
+
+void Config::add_library_root(std::string_view const root) {
+	if (root.empty() || std::ranges::find(m_library_roots, root) != m_library_roots.end()) { return; }
+	m_library_roots.emplace_back(root);
+	m_dirty = true;
+}
+
+void Config::remove_library_root(std::string_view const root) {
+	if (std::erase(m_library_roots, root) == 0) { return; }
+	m_dirty = true;
+}
+
+void Config::update() {
+	if (!m_dirty) { return; }
+	auto const now = Clock::now();
+	if (now - m_last_save < save_debounce_v) { return; }
+	queue_save();
+}
+
+void Config::watch() {
+	if (m_watcher) { return; }
+	m_watcher.emplace();
+	auto const directory = fs::absolute(path).parent_path().generic_string();
+	if (!m_watcher->watch(directory)) {
+		log.warn("failed to watch config directory: {}", directory);
+		m_watcher.reset();
+	}
+}
+
+auto Config::poll_reload() -> bool {
+	if (!m_watcher) { return false; }
+	m_watch_events.clear();
+	m_watcher->drain_to(m_watch_events);
+	auto const filename = fs::path{path}.filename();
+	auto const is_config = [&](FileWatcher::Event const& event) {
+		return event.kind == FileWatcher::Kind::Changed && fs::path{event.path}.filename() == filename;
+	};
+	if (std::ranges::none_of(m_watch_events, is_config)) { return false; }
+
+	// a queued save would otherwise be read half way through a burst of writes, and mistaken for an external edit
+	m_writer.flush();
+	auto text = std::string{};
+	if (!read_text(path, text)) { return false; }
+	// anything but the exact contents last loaded / written is an external change, even an older state of ours
+	if (text == m_known) { return false; }
+
+	if (m_dirty) { log.warn("discarding unsaved config changes, {} was edited externally", path); }
+	m_ini.parse(text);
+	assign_from_ini();
+	m_known = std::move(text);
+	log.info("reloaded config from: {}", path);
+	return true;
+}
+
+auto Config::load_silent() -> bool {
+	auto text = std::string{};
+	if (!read_text(path, text)) { return false; }
+	m_ini.parse(text);
+	assign_from_ini();
+	m_known = std::move(text);
+	return true;
+}
+
+void Config::assign_from_ini() {
+	m_ini.assign_to(m_volume, "volume");
+	m_ini.assign_to(m_balance, "balance");
+	auto str = std::string{};
+	if (m_ini.assign_to(str, "repeat")) { from_str(repeat_str_v, str, m_repeat); }
+	if (m_ini.assign_to(str, "normalize")) { from_str(normalize_str_v, str, m_normalize); }
+	m_ini.assign_to(m_show_meters, "meters");
+	m_ini.assign_to(m_show_spectrum, "spectrum");
+	m_library_roots.clear();
+	m_ini.for_each(library_section_v, [this](std::string_view const key, std::string_view const value) {
+		if (key.starts_with(library_root_prefix_v) && !value.empty()) { m_library_roots.emplace_back(value); }
+	});
+	m_dirty = false;
+}
+
+auto Config::save_silent() -> bool {
+	sync_ini();
+	auto text = m_ini.serialize();
+	if (!write_atomic(path, text)) { return false; }
+	m_known = std::move(text);
+	m_dirty = false;
+	m_last_save = Clock::now();
+	return true;
+}
+
+void Config::queue_save() {
+	RIFF_PROFILE_ZONE(ConfigSave);
+	sync_ini();
+	m_known = m_ini.serialize();
+	m_writer.submit(path, m_known);
+	m_dirty = false;
+	m_last_save = Clock::now();
+}
+
+void Config::sync_ini() {
+	m_ini.set_value("volume", std::format("{}", m_volume));
+	m_ini.set_value("balance", std::format("{:.1f}", m_balance));
+	m_ini.set_value("repeat", repeat_str_v[m_repeat]);
+	m_ini.set_value("normalize", normalize_str_v[m_normalize]);
+	m_ini.set_value("meters", std::format("{}", m_show_meters));
+	m_ini.set_value("spectrum", std::format("{}", m_show_spectrum));
+
+	auto stale = std::vector<std::string>{};
+	m_ini.for_each(library_section_v, [&](std::string_view const key, std::string_view /*value*/) {
+		if (key.starts_with(library_root_prefix_v)) { stale.emplace_back(key); }
+	});
+	for (std::size_t i = 0; i < m_library_roots.size(); ++i) {
+		auto const key = std::format("{}{}", library_root_prefix_v, i);
+		std::erase(stale, key);
+		m_ini.set_value({library_section_v, key}, m_library_roots.at(i));
+	}
+	for (auto const& key : stale) { m_ini.remove({library_section_v, key}); }
+}
+} // namespace riff
@@ -0,0 +1,90 @@
+#pragma once
+#include <file_watcher.hpp>
+#include <file_writer.hpp>
+#include <ini.hpp>
+#include <klib/c_string.hpp>
+#include <normalize.hpp>
+#include <repeat.hpp>
+#include <time.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace riff {
+class Config {
+  public:
+	static constexpr auto save_debounce_v{1s};
+
+	Config(Config const&) = delete;
+	Config(Config&&) = delete;
+	auto operator=(Config const&) = delete;
+	auto operator=(Config&&) = delete;
+
+	Config() = default;
+	~Config() {
+		if (m_dirty) { queue_save(); }
+	}
+
+	auto load() -> bool;
+	auto save() -> bool;
+	auto load_or_create() -> bool;
+
+	[[nodiscard]] auto get_volume() const -> int { return m_volume; }
+	void set_volume(int volume);
+
+	[[nodiscard]] auto get_balance() const -> float { return m_balance; }
+	void set_balance(float balance);
+
+	[[nodiscard]] auto get_repeat() const -> Repeat { return m_repeat; }
+	void set_repeat(Repeat repeat);
+
+	[[nodiscard]] auto get_normalize() const -> Normalize { return m_normalize; }
+	void set_normalize(Normalize normalize);
+
+	[[nodiscard]] auto get_show_meters() const -> bool { return m_show_meters; }
+	void set_show_meters(bool show);
+
+	[[nodiscard]] auto get_show_spectrum() const -> bool { return m_show_spectrum; }
+	void set_show_spectrum(bool show);
+
+	[[nodiscard]] auto get_library_roots() const -> std::vector<std::string> const& { return m_library_roots; }
+	void add_library_root(std::string_view root);
+	void remove_library_root(std::string_view root);
+
+	void update();
+
+	// watches path for edits by other processes
+	void watch();
+	// reloads values if path was changed by another process since the last call, returns true if reloaded
+	[[nodiscard]] auto poll_reload() -> bool;
+
+	std::string path{"riff.conf"};
+
+  private:
+	auto load_silent() -> bool;
+	void assign_from_ini();
+	auto save_silent() -> bool;
+	void queue_save();
+
+	// writes current values into m_ini, leaving unchanged lines (and comments) as loaded
+	void sync_ini();
+
+	int m_volume{100};
+	float m_balance{0.0f};
+	Repeat m_repeat{Repeat::None};
+	Normalize m_normalize{Normalize::Off};
+	bool m_show_meters{};
+	bool m_show_spectrum{};
+	std::vector<std::string> m_library_roots{};
+
+	Ini m_ini{};
+	bool m_dirty{};
+	Clock::time_point m_last_save{};
+
+	FileWriter m_writer{};
+	// contents last loaded or written, to tell our own writes apart from external edits
+	std::string m_known{};
+	std::optional<FileWatcher> m_watcher{};
+	std::vector<FileWatcher::Event> m_watch_events{};
+};
+} // namespace riff
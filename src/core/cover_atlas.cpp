@@ -0,0 +1,68 @@
+#include <cover_atlas.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace riff {
+CoverAtlas::CoverAtlas()
+	: m_pixels(std::size_t(extent_v) * extent_v * 4), m_slots(std::size_t(columns_v) * columns_v) {}
+
+auto CoverAtlas::find(std::string_view const path) -> std::optional<Region> {
+	auto const it = m_lookup.find(path);
+	if (it == m_lookup.end()) { return {}; }
+	m_slots.at(it->second).last_used = m_frame;
+	auto const cell = get_cell(it->second);
+	static constexpr auto scale_v = 1.0f / float(extent_v);
+	return Region{
+		.u0 = float(cell.x) * scale_v,
+		.v0 = float(cell.y) * scale_v,
+		.u1 = float(cell.x + cell_size_v) * scale_v,
+		.v1 = float(cell.y + cell_size_v) * scale_v,
+	};
+}
+
+void CoverAtlas::insert(std::string_view const path, Bitmap const& thumbnail) {
+	if (thumbnail.width != cell_size_v || thumbnail.height != cell_size_v) { return; }
+	auto index = std::size_t{};
+	if (auto const it = m_lookup.find(path); it != m_lookup.end()) {
+		index = it->second;
+	} else {
+		index = get_victim();
+		auto& slot = m_slots.at(index);
+		if (!slot.path.empty()) { m_lookup.erase(slot.path); }
+		slot.path = path;
+		m_lookup.emplace(slot.path, index);
+	}
+	m_slots.at(index).last_used = m_frame;
+
+	auto const cell = get_cell(index);
+	static constexpr auto row_size_v = std::size_t(cell_size_v) * 4;
+	for (std::uint32_t y = 0; y < cell_size_v; ++y) {
+		auto const* src = thumbnail.pixels.data() + (y * row_size_v);
+		auto* dst = m_pixels.data() + ((std::size_t(cell.y + y) * extent_v + cell.x) * 4);
+		std::copy_n(src, row_size_v, dst);
+	}
+	m_dirty.push_back(cell);
+}
+
+void CoverAtlas::remove(std::string_view const path) {
+	auto const it = m_lookup.find(path);
+	if (it == m_lookup.end()) { return; }
+	m_slots.at(it->second) = {};
+	m_lookup.erase(it);
+}
+
+void CoverAtlas::drain_dirty_to(std::vector<Cell>& out) {
+	out.insert(out.end(), m_dirty.begin(), m_dirty.end());
+	m_dirty.clear();
+}
+
+auto CoverAtlas::get_cell(std::size_t const index) -> Cell {
+	assert(index < std::size_t(columns_v) * columns_v);
+	return Cell{.x = std::uint32_t(index % columns_v) * cell_size_v, .y = std::uint32_t(index / columns_v) * cell_size_v};
+}
+
+auto CoverAtlas::get_victim() const -> std::size_t {
+	auto const it = std::ranges::min_element(m_slots, {}, &Slot::last_used);
+	return std::size_t(it - m_slots.begin());
+}
+} // namespace riff
@@ -0,0 +1,65 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <cover_scanner.hpp>
+#include <image.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace riff {
+// Thumbnails packed into fixed cells of a single RGBA image, so one texture serves every cover on screen.
+// When full, the least recently used cell is overwritten. Written cells are queued for upload.
+class CoverAtlas : public klib::Pinned {
+  public:
+	static constexpr std::uint32_t cell_size_v{CoverScanner::thumbnail_size_v};
+	static constexpr std::uint32_t columns_v{16};
+	static constexpr std::uint32_t extent_v{cell_size_v * columns_v};
+
+	struct Region {
+		float u0{};
+		float v0{};
+		float u1{};
+		float v1{};
+	};
+
+	struct Cell {
+		std::uint32_t x{};
+		std::uint32_t y{};
+	};
+
+	CoverAtlas();
+
+	// marks the cell as used in the current frame
+	[[nodiscard]] auto find(std::string_view path) -> std::optional<Region>;
+	void insert(std::string_view path, Bitmap const& thumbnail);
+	void remove(std::string_view path);
+	void next_frame() { ++m_frame; }
+
+	// extent_v x extent_v RGBA
+	[[nodiscard]] auto get_pixels() const -> std::span<std::uint8_t const> { return m_pixels; }
+	// cells written since the last call
+	void drain_dirty_to(std::vector<Cell>& out);
+
+  private:
+	struct Slot {
+		std::string path{};
+		std::uint64_t last_used{};
+	};
+
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	[[nodiscard]] static auto get_cell(std::size_t index) -> Cell;
+	[[nodiscard]] auto get_victim() const -> std::size_t;
+
+	std::vector<std::uint8_t> m_pixels{};
+	std::vector<Slot> m_slots{};
+	std::unordered_map<std::string, std::size_t, Hash, std::equal_to<>> m_lookup{};
+	std::vector<Cell> m_dirty{};
+	std::uint64_t m_frame{1};
+};
+} // namespace riff
@@ -0,0 +1,185 @@
+#include <cover_scanner.hpp>
+#include <file_writer.hpp>
+#include <log.hpp>
+#include <tag_reader.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr auto magic_v = std::string_view{"riff-thumb"};
+constexpr auto extension_v = std::string_view{".thumb"};
+
+constexpr auto folder_names_v = std::array<std::string_view, 4>{"cover", "folder", "front", "album"};
+constexpr auto folder_extensions_v = std::array<std::string_view, 3>{".jpg", ".jpeg", ".png"};
+
+[[nodiscard]] auto read_file(fs::path const& path) -> std::vector<std::byte> {
+	auto file = std::ifstream{path, std::ios::binary | std::ios::ate};
+	if (!file) { return {}; }
+	auto ret = std::vector<std::byte>(std::size_t(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(ret.data()), std::streamsize(ret.size())); // NOLINT
+	return ret;
+}
+
+[[nodiscard]] auto to_thumbnail(std::span<std::byte const> const bytes) -> Bitmap {
+	if (bytes.empty()) { return {}; }
+	auto const bitmap = decode_image(bytes, CoverScanner::thumbnail_size_v);
+	if (!bitmap) { return {}; }
+	return make_thumbnail(*bitmap, CoverScanner::thumbnail_size_v);
+}
+
+// 64 bit FNV-1a: unlike std::hash, the same across builds and platforms, so cache file names stay valid
+[[nodiscard]] constexpr auto fnv1a(std::string_view const str) -> std::uint64_t {
+	auto ret = std::uint64_t{0xcbf29ce484222325};
+	for (auto const c : str) {
+		ret ^= std::uint8_t(c);
+		ret *= 0x100000001b3;
+	}
+	return ret;
+}
+
+[[nodiscard]] auto get_cache_path(std::string const& directory, std::string const& path) -> std::string {
+	auto ec = std::error_code{};
+	auto const size = fs::file_size(path, ec);
+	auto const mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+	auto const key = fnv1a(std::format("{}|{}|{}", path, size, mtime));
+	return std::format("{}/{:016x}{}", directory, key, extension_v);
+}
+
+// magic, width, height (32 bit little endian), RGBA pixels
+[[nodiscard]] auto load_cached(std::string const& path) -> std::optional<Bitmap> {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return {}; }
+	auto header = std::array<char, magic_v.size() + 8>{};
+	if (!file.read(header.data(), header.size()) || std::string_view{header.data(), magic_v.size()} != magic_v) {
+		return {};
+	}
+	auto const read_u32 = [&header](std::size_t const at) {
+		auto bytes = std::array<char, 4>{};
+		std::memcpy(bytes.data(), header.data() + at, bytes.size());
+		if constexpr (std::endian::native == std::endian::big) { std::ranges::reverse(bytes); }
+		return std::bit_cast<std::uint32_t>(bytes);
+	};
+	auto ret = Bitmap{.width = read_u32(magic_v.size()), .height = read_u32(magic_v.size() + 4)};
+	if (ret.width > CoverScanner::thumbnail_size_v || ret.height > CoverScanner::thumbnail_size_v) { return {}; }
+	ret.pixels.resize(std::size_t(ret.width) * ret.height * 4);
+	auto* data = reinterpret_cast<char*>(ret.pixels.data()); // NOLINT
+	if (!file.read(data, std::streamsize(ret.pixels.size()))) { return {}; }
+	return ret;
+}
+
+[[nodiscard]] auto serialize(Bitmap const& bitmap) -> std::string {
+	auto ret = std::string{magic_v};
+	for (auto value : {bitmap.width, bitmap.height}) {
+		auto bytes = std::bit_cast<std::array<char, 4>>(value);
+		if constexpr (std::endian::native == std::endian::big) { std::ranges::reverse(bytes); }
+		ret.append(bytes.data(), bytes.size());
+	}
+	ret.append(reinterpret_cast<char const*>(bitmap.pixels.data()), bitmap.pixels.size()); // NOLINT
+	return ret;
+}
+
+[[nodiscard]] auto is_folder_image(fs::path const& path) -> bool {
+	auto to_lower = [](std::string str) {
+		std::ranges::transform(str, str.begin(), [](unsigned char const c) { return char(std::tolower(c)); });
+		return str;
+	};
+	auto const stem = to_lower(path.stem().string());
+	auto const extension = to_lower(path.extension().string());
+	return std::ranges::find(folder_names_v, stem) != folder_names_v.end() &&
+		   std::ranges::find(folder_extensions_v, extension) != folder_extensions_v.end();
+}
+} // namespace
+
+CoverScanner::CoverScanner() {
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+void CoverScanner::enqueue(std::string_view const path) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (!m_pending.emplace(path).second) { return; }
+	m_queue.emplace_back(path);
+	m_cv.notify_one();
+}
+
+void CoverScanner::drain_to(std::vector<Result>& out) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_results.empty()) { return; }
+	std::ranges::move(m_results, std::back_inserter(out));
+	m_results.clear();
+}
+
+void CoverScanner::run(std::stop_token const& stop) {
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (!m_cv.wait(lock, stop, [this] { return !m_queue.empty(); })) { return; }
+		auto path = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+
+		if (!m_pruned) {
+			prune_cache();
+			m_pruned = true;
+		}
+		auto thumbnail = get_thumbnail(path);
+
+		lock.lock();
+		m_pending.erase(path);
+		m_results.push_back(Result{.path = std::move(path), .thumbnail = std::move(thumbnail)});
+	}
+}
+
+auto CoverScanner::get_thumbnail(std::string const& path) -> Bitmap {
+	auto const cache_path = get_cache_path(directory, path);
+	if (auto ret = load_cached(cache_path)) {
+		auto ec = std::error_code{};
+		fs::last_write_time(cache_path, fs::file_time_type::clock::now(), ec);
+		return std::move(*ret);
+	}
+
+	auto ret = to_thumbnail(read_cover_art(path));
+	if (ret.is_empty()) { ret = get_folder_thumbnail(fs::path{path}.parent_path().generic_string()); }
+
+	auto ec = std::error_code{};
+	fs::create_directories(directory, ec);
+	if (!write_atomic(cache_path, serialize(ret))) { log.warn("failed to write thumbnail: {}", cache_path); }
+	return ret;
+}
+
+auto CoverScanner::get_folder_thumbnail(std::string const& folder) -> Bitmap const& {
+	if (auto const it = m_folders.find(folder); it != m_folders.end()) { return it->second; }
+	auto thumbnail = Bitmap{};
+	auto ec = std::error_code{};
+	for (auto it = fs::directory_iterator{folder, ec}; !ec && it != fs::directory_iterator{}; it.increment(ec)) {
+		if (!it->is_regular_file(ec) || !is_folder_image(it->path())) { continue; }
+		thumbnail = to_thumbnail(read_file(it->path()));
+		if (!thumbnail.is_empty()) { break; }
+	}
+	return m_folders.insert_or_assign(folder, std::move(thumbnail)).first->second;
+}
+
+// removes the least recently used thumbnails, along with those of files that changed or went away
+void CoverScanner::prune_cache() const {
+	auto entries = std::vector<std::pair<fs::file_time_type, fs::path>>{};
+	auto ec = std::error_code{};
+	for (auto it = fs::directory_iterator{directory, ec}; !ec && it != fs::directory_iterator{}; it.increment(ec)) {
+		if (it->path().extension() != extension_v) { continue; }
+		entries.emplace_back(it->last_write_time(ec), it->path());
+	}
+	if (entries.size() <= max_cached_v) { return; }
+	auto const excess = entries.size() - max_cached_v;
+	std::ranges::nth_element(entries, entries.begin() + std::ptrdiff_t(excess), {}, &decltype(entries)::value_type::first);
+	for (auto const& [_, path] : std::span{entries}.first(excess)) { fs::remove(path, ec); }
+	log.info("pruned {} cached thumbnails from: {}", excess, directory);
+}
+} // namespace riff
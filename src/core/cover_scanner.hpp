@@ -0,0 +1,59 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <image.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace riff {
+// Finds cover art for enqueued tracks on a worker thread: embedded pictures, else an image in the track's directory.
+// Thumbnails (including "no art") are cached on disk per path, size and mtime: art is decoded once per file.
+// Cache hits refresh the file's mtime, the least recently used thumbnails beyond max_cached_v are pruned once per run.
+class CoverScanner : public klib::Pinned {
+  public:
+	struct Result {
+		std::string path{};
+		// empty if the track has no usable art
+		Bitmap thumbnail{};
+	};
+
+	static constexpr std::uint32_t thumbnail_size_v{64};
+	// at most 16KiB each
+	static constexpr std::size_t max_cached_v{8192};
+
+	CoverScanner();
+
+	void enqueue(std::string_view path);
+	void drain_to(std::vector<Result>& out);
+
+	// must not change after the first enqueue
+	std::string directory{"riff-covers"};
+
+  private:
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	void run(std::stop_token const& stop);
+	[[nodiscard]] auto get_thumbnail(std::string const& path) -> Bitmap;
+	[[nodiscard]] auto get_folder_thumbnail(std::string const& folder) -> Bitmap const&;
+	void prune_cache() const;
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::deque<std::string> m_queue{};
+	std::unordered_set<std::string, Hash, std::equal_to<>> m_pending{};
+	std::vector<Result> m_results{};
+
+	// worker thread only
+	std::unordered_map<std::string, Bitmap, Hash, std::equal_to<>> m_folders{};
+	bool m_pruned{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
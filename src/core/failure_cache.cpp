@@ -0,0 +1,78 @@
+#include <failure_cache.hpp>
+#include <log.hpp>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+template <typename Type>
+auto parse_number(std::string_view& line, Type& out) -> bool {
+	auto const* end = line.data() + line.size();
+	auto const [ptr, ec] = std::from_chars(line.data(), end, out);
+	if (ec != std::errc{} || ptr == end || *ptr != ' ') { return false; }
+	line.remove_prefix(std::size_t(ptr - line.data()) + 1);
+	return true;
+}
+} // namespace
+
+auto FailureCache::get_stamp(std::string const& path) -> Stamp {
+	auto ec = std::error_code{};
+	return Stamp{
+		.size = fs::file_size(path, ec),
+		.mtime = fs::last_write_time(path, ec).time_since_epoch().count(),
+	};
+}
+
+// one "size mtime path" entry per line
+auto FailureCache::load() -> bool {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return false; }
+	auto const text = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	m_entries.clear();
+	auto remain = std::string_view{text};
+	while (!remain.empty()) {
+		auto const eol = remain.find('\n');
+		auto line = remain.substr(0, eol);
+		remain.remove_prefix(eol == std::string_view::npos ? remain.size() : eol + 1);
+		auto stamp = Stamp{};
+		if (!parse_number(line, stamp.size) || !parse_number(line, stamp.mtime) || line.empty()) { continue; }
+		m_entries.insert_or_assign(std::string{line}, stamp);
+	}
+	log.info("loaded {} known decode failures from: {}", m_entries.size(), path);
+	return true;
+}
+
+auto FailureCache::contains(std::string_view const path, Stamp const stamp) const -> bool {
+	auto const it = m_entries.find(path);
+	return it != m_entries.end() && it->second == stamp;
+}
+
+void FailureCache::insert(std::string path, Stamp const stamp) {
+	auto const [it, inserted] = m_entries.try_emplace(std::move(path), stamp);
+	if (!inserted) {
+		if (it->second == stamp) { return; }
+		it->second = stamp;
+	}
+	save();
+}
+
+void FailureCache::erase(std::string_view const path) {
+	auto const it = m_entries.find(path);
+	if (it == m_entries.end()) { return; }
+	m_entries.erase(it);
+	save();
+}
+
+void FailureCache::save() {
+	auto text = std::string{};
+	for (auto const& [file, stamp] : m_entries) {
+		std::format_to(std::back_inserter(text), "{} {} {}\n", stamp.size, stamp.mtime, file);
+	}
+	m_writer.submit(path, std::move(text));
+}
+} // namespace riff
@@ -0,0 +1,42 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <file_writer.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace riff {
+// Files that failed to decode, stamped with their size and mtime when they failed.
+// A failure only holds while the stamp matches: once the file changes it is eligible for loading again.
+class FailureCache : public klib::Pinned {
+  public:
+	struct Stamp {
+		std::uint64_t size{};
+		std::int64_t mtime{};
+
+		auto operator==(Stamp const&) const -> bool = default;
+	};
+
+	[[nodiscard]] static auto get_stamp(std::string const& path) -> Stamp;
+
+	auto load() -> bool;
+
+	[[nodiscard]] auto contains(std::string_view path, Stamp stamp) const -> bool;
+	void insert(std::string path, Stamp stamp);
+	void erase(std::string_view path);
+
+	[[nodiscard]] auto get_size() const -> std::size_t { return m_entries.size(); }
+
+	std::string path{"riff.failures"};
+
+  private:
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	void save();
+
+	std::unordered_map<std::string, Stamp, Hash, std::equal_to<>> m_entries{};
+	FileWriter m_writer{};
+};
+} // namespace riff
@@ -0,0 +1,63 @@
+#include <fft.hpp>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace riff {
+Fft::Fft(std::size_t const size) {
+	assert(size >= 2 && std::has_single_bit(size));
+	auto const bits = std::countr_zero(size);
+	m_bit_reverse.resize(size);
+	for (std::uint32_t i = 0; i < size; ++i) {
+		auto reversed = std::uint32_t{};
+		for (int b = 0; b < bits; ++b) { reversed |= ((i >> b) & 1u) << (bits - 1 - b); }
+		m_bit_reverse[i] = reversed;
+	}
+
+	m_twiddle_real.reserve(size);
+	m_twiddle_imag.reserve(size);
+	for (std::size_t half = 1; half < size; half <<= 1) {
+		for (std::size_t k = 0; k < half; ++k) {
+			auto const angle = -std::numbers::pi * double(k) / double(half);
+			m_twiddle_real.push_back(float(std::cos(angle)));
+			m_twiddle_imag.push_back(float(std::sin(angle)));
+		}
+	}
+}
+
+void Fft::transform(std::span<float> const real, std::span<float> const imag) const {
+	auto const size = get_size();
+	assert(real.size() == size && imag.size() == size);
+
+	for (std::size_t i = 0; i < size; ++i) {
+		auto const j = m_bit_reverse[i];
+		if (i < j) {
+			std::swap(real[i], real[j]);
+			std::swap(imag[i], imag[j]);
+		}
+	}
+
+	auto const* wr = m_twiddle_real.data();
+	auto const* wi = m_twiddle_imag.data();
+	for (std::size_t half = 1; half < size; half <<= 1) {
+		for (std::size_t base = 0; base < size; base += 2 * half) {
+			auto* ar = real.data() + base;
+			auto* ai = imag.data() + base;
+			auto* br = ar + half;
+			auto* bi = ai + half;
+			for (std::size_t k = 0; k < half; ++k) {
+				auto const tr = (br[k] * wr[k]) - (bi[k] * wi[k]);
+				auto const ti = (br[k] * wi[k]) + (bi[k] * wr[k]);
+				br[k] = ar[k] - tr;
+				bi[k] = ai[k] - ti;
+				ar[k] += tr;
+				ai[k] += ti;
+			}
+		}
+		wr += half;
+		wi += half;
+	}
+}
+} // namespace riff
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace riff {
+// Iterative radix-2 complex FFT over split real / imaginary arrays.
+class Fft {
+  public:
+	explicit Fft(std::size_t size);
+
+	[[nodiscard]] auto get_size() const -> std::size_t { return m_bit_reverse.size(); }
+
+	void transform(std::span<float> real, std::span<float> imag) const;
+
+  private:
+	std::vector<std::uint32_t> m_bit_reverse{};
+	// twiddles laid out contiguously per stage, so each butterfly loop streams through memory and vectorizes
+	std::vector<float> m_twiddle_real{};
+	std::vector<float> m_twiddle_imag{};
+};
+} // namespace riff
@@ -0,0 +1,56 @@
+#include <file_type.hpp>
+#include <media_probe.hpp>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+[[nodiscard]] auto starts_with(std::span<std::byte const> const bytes, std::string_view const prefix) -> bool {
+	if (bytes.size() < prefix.size()) { return false; }
+	return std::ranges::equal(bytes.first(prefix.size()), prefix, {}, {}, [](char const c) { return std::byte(c); });
+}
+
+[[nodiscard]] auto is_text(std::span<std::byte const> const bytes) -> bool {
+	return std::ranges::find(bytes, std::byte{}) == bytes.end();
+}
+} // namespace
+
+auto sniff_file_type(std::span<std::byte const> head, std::string_view const extension) -> FileType {
+	if (sniff_media(head) != AudioFormat::Unknown) { return FileType::Music; }
+	if (starts_with(head, "\xEF\xBB\xBF")) { head = head.subspan(3); }
+	if (starts_with(head, "#EXTM3U")) { return FileType::Playlist; }
+	if (get_file_type(extension) == FileType::Playlist && is_text(head)) { return FileType::Playlist; }
+	return FileType::Unknown;
+}
+
+auto sniff_file_type(std::string const& path) -> FileType {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return FileType::Unknown; }
+	auto head = std::array<std::byte, sniff_size_v>{};
+	file.read(reinterpret_cast<char*>(head.data()), std::streamsize(head.size())); // NOLINT
+	auto const count = std::size_t(file.gcount());
+	auto const extension = fs::path{path}.extension().generic_string();
+	return sniff_file_type(std::span{head}.first(count), extension);
+}
+
+auto sniff_file_types(std::span<std::string const> const paths) -> std::vector<FileType> {
+	static constexpr std::size_t batch_v{64};
+	auto ret = std::vector<FileType>(paths.size());
+	auto next = std::atomic<std::size_t>{};
+	auto const sniff = [&] {
+		for (auto i = next++; i < paths.size(); i = next++) { ret[i] = sniff_file_type(paths[i]); }
+	};
+	auto const cores = std::max(std::thread::hardware_concurrency(), 1u);
+	auto const threads = std::clamp<std::size_t>(paths.size() / batch_v, 1, cores);
+	{
+		auto workers = std::vector<std::jthread>{};
+		for (std::size_t i = 1; i < threads; ++i) { workers.emplace_back(sniff); }
+		sniff();
+	}
+	return ret;
+}
+} // namespace riff
@@ -0,0 +1,30 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace riff {
+enum class FileType : std::int8_t { Unknown, Music, Playlist };
+
+[[nodiscard]] constexpr auto get_file_type(std::string_view const extension) {
+	static constexpr auto music_v = std::array{".wav", ".mp3", ".flac"};
+	if (std::ranges::find(music_v, extension) != music_v.end()) { return FileType::Music; }
+	static constexpr auto playlist_v = std::array{".m3u", ".m3u8"};
+	if (std::ranges::find(playlist_v, extension) != playlist_v.end()) { return FileType::Playlist; }
+	return FileType::Unknown;
+}
+
+// content based detection, the extension is only consulted for M3U playlists without an #EXTM3U header.
+// at most sniff_size_v bytes are read from each file, unreadable files are Unknown.
+inline constexpr std::size_t sniff_size_v{4 * 1024};
+
+[[nodiscard]] auto sniff_file_type(std::span<std::byte const> head, std::string_view extension) -> FileType;
+[[nodiscard]] auto sniff_file_type(std::string const& path) -> FileType;
+// sniffs large batches across multiple threads, ret[i] is the type of paths[i]
+[[nodiscard]] auto sniff_file_types(std::span<std::string const> paths) -> std::vector<FileType>;
+} // namespace riff
@@ -0,0 +1,202 @@
+#include <file_watcher.hpp>
+#include <log.hpp>
+#include <time.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr auto min_poll_interval_v = std::chrono::seconds{1};
+constexpr auto max_poll_interval_v = std::chrono::seconds{16};
+// directories listed per tick: a sweep over N directories takes N / poll_batch_v ticks
+constexpr std::size_t poll_batch_v{32};
+
+[[nodiscard]] auto join(std::string_view const directory, std::string_view const name) -> std::string {
+	if (name.empty()) { return std::string{directory}; }
+	return (fs::path{directory} / name).generic_string();
+}
+} // namespace
+
+FileWatcher::FileWatcher() : m_poll_interval(min_poll_interval_v) {
+#if defined(__linux__)
+	m_fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_fd < 0) { log.warn("inotify unavailable, falling back to polling"); }
+#endif
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+FileWatcher::~FileWatcher() {
+	m_thread = {};
+#if defined(__linux__)
+	if (m_fd >= 0) { ::close(m_fd); }
+#endif
+}
+
+auto FileWatcher::watch(std::string_view const directory) -> bool {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_descriptors.contains(directory) || m_listings.contains(directory)) { return true; }
+#if defined(__linux__)
+	if (m_fd >= 0 && !m_watches_exhausted) {
+		static constexpr std::uint32_t mask_v =
+			IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+		auto const wd = ::inotify_add_watch(m_fd, std::string{directory}.c_str(), mask_v);
+		if (wd >= 0) {
+			m_descriptors.emplace(directory, wd);
+			m_directories.insert_or_assign(wd, std::string{directory});
+			return true;
+		}
+		if (errno != ENOSPC) { return false; }
+		// max_user_watches reached: stop asking, existing watches stay and the rest are polled
+		log.warn("inotify watch limit reached at {} directories, polling the rest", m_descriptors.size());
+		m_watches_exhausted = true;
+	}
+#endif
+	auto ec = std::error_code{};
+	if (!fs::is_directory(directory, ec)) { return false; }
+	m_listings.emplace(directory, list(std::string{directory}));
+	return true;
+}
+
+void FileWatcher::unwatch(std::string_view const directory) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (auto const it = m_descriptors.find(directory); it != m_descriptors.end()) {
+#if defined(__linux__)
+		::inotify_rm_watch(m_fd, it->second);
+#endif
+		m_directories.erase(it->second);
+		m_descriptors.erase(it);
+	}
+	if (auto const it = m_listings.find(directory); it != m_listings.end()) { m_listings.erase(it); }
+}
+
+auto FileWatcher::is_watching(std::string_view const directory) const -> bool {
+	auto lock = std::scoped_lock{m_mutex};
+	return m_descriptors.contains(directory) || m_listings.contains(directory);
+}
+
+void FileWatcher::drain_to(std::vector<Event>& out) {
+	auto lock = std::scoped_lock{m_mutex};
+	for (auto& [path, kind] : m_events) { out.push_back(Event{.path = path, .kind = kind}); }
+	m_events.clear();
+}
+
+void FileWatcher::run(std::stop_token const& stop) {
+	auto next_poll = Clock::now();
+	while (!stop.stop_requested()) {
+		if (m_fd >= 0) {
+			read_events();
+		} else {
+			auto lock = std::unique_lock{m_mutex};
+			m_cv.wait_until(lock, stop, next_poll, [] { return false; });
+		}
+		// everything without inotify, else only directories past the watch limit
+		if (Clock::now() < next_poll) { continue; }
+		poll_directories();
+		next_poll = Clock::now() + m_poll_interval;
+	}
+}
+
+void FileWatcher::push(std::string path, Kind const kind) { m_events.insert_or_assign(std::move(path), kind); }
+
+void FileWatcher::read_events() {
+#if defined(__linux__)
+	auto pfd = pollfd{.fd = m_fd, .events = POLLIN, .revents = 0};
+	if (::poll(&pfd, 1, 100) <= 0) { return; }
+
+	alignas(inotify_event) auto buffer = std::array<char, 16 * 1024>{};
+	while (true) {
+		auto const length = ::read(m_fd, buffer.data(), buffer.size());
+		if (length <= 0) { return; }
+		auto lock = std::scoped_lock{m_mutex};
+		for (auto offset = 0z; offset < length;) {
+			auto const* event = reinterpret_cast<inotify_event const*>(buffer.data() + offset); // NOLINT
+			offset += std::ptrdiff_t(sizeof(inotify_event) + event->len);
+			if ((event->mask & IN_Q_OVERFLOW) != 0) {
+				// events were dropped: report every directory as changed so consumers rescan
+				for (auto const& [_, directory] : m_directories) { push(directory, Kind::Changed); }
+				continue;
+			}
+			auto const it = m_directories.find(event->wd);
+			if (it == m_directories.end()) { continue; }
+			auto const name = event->len > 0 ? std::string_view{event->name} : std::string_view{};
+			auto const removed = (event->mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF)) != 0;
+			push(join(it->second, name), removed ? Kind::Removed : Kind::Changed);
+			if ((event->mask & IN_IGNORED) != 0) {
+				m_descriptors.erase(it->second);
+				m_directories.erase(it);
+			}
+		}
+	}
+#endif
+}
+
+void FileWatcher::poll_directories() {
+	auto directories = std::vector<std::string>{};
+	auto wrapped = false;
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		auto const count = std::min(poll_batch_v, m_listings.size());
+		directories.reserve(count);
+		for (auto it = m_listings.upper_bound(m_poll_cursor); directories.size() < count; ++it) {
+			if (it == m_listings.end()) {
+				it = m_listings.begin();
+				wrapped = true;
+			}
+			directories.push_back(it->first);
+		}
+	}
+	if (!directories.empty()) { m_poll_cursor = directories.back(); }
+	if (wrapped) {
+		// a full sweep found nothing: poll less often
+		if (!m_sweep_changed) { m_poll_interval = std::min<Clock::duration>(m_poll_interval * 2, max_poll_interval_v); }
+		m_sweep_changed = false;
+	}
+
+	auto changed = false;
+	for (auto const& directory : directories) {
+		auto listing = list(directory);
+		auto lock = std::scoped_lock{m_mutex};
+		auto const it = m_listings.find(directory);
+		if (it == m_listings.end()) { continue; }
+		for (auto const& [path, snapshot] : listing) {
+			auto const prev = it->second.find(path);
+			if (prev != it->second.end() && prev->second.mtime == snapshot.mtime && prev->second.size == snapshot.size) {
+				continue;
+			}
+			push(path, Kind::Changed);
+			changed = true;
+		}
+		for (auto const& [path, _] : it->second) {
+			if (listing.contains(path)) { continue; }
+			push(path, Kind::Removed);
+			changed = true;
+		}
+		it->second = std::move(listing);
+	}
+	if (changed) {
+		m_poll_interval = min_poll_interval_v;
+		m_sweep_changed = true;
+	}
+}
+
+auto FileWatcher::list(std::string const& directory) -> Listing {
+	auto ret = Listing{};
+	auto ec = std::error_code{};
+	for (auto const& entry : fs::directory_iterator{directory, ec}) {
+		auto const mtime = entry.last_write_time(ec).time_since_epoch().count();
+		auto const size = entry.is_regular_file(ec) ? entry.file_size(ec) : 0;
+		ret.insert_or_assign(entry.path().generic_string(), Snapshot{.mtime = std::int64_t(mtime), .size = size});
+	}
+	return ret;
+}
+} // namespace riff
@@ -0,0 +1,73 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <time.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace riff {
+// Watches directories (non-recursively) on a background thread: inotify on Linux, periodic polling elsewhere
+// (and for directories beyond the inotify watch limit).
+// Polled directories are listed a batch per tick, ticks back off while full sweeps find nothing.
+// Events are coalesced per path until drained, the latest kind wins.
+class FileWatcher : public klib::Pinned {
+  public:
+	enum class Kind : std::int8_t { Changed, Removed };
+
+	struct Event {
+		std::string path{};
+		Kind kind{};
+	};
+
+	FileWatcher();
+	~FileWatcher();
+
+	auto watch(std::string_view directory) -> bool;
+	void unwatch(std::string_view directory);
+	[[nodiscard]] auto is_watching(std::string_view directory) const -> bool;
+
+	void drain_to(std::vector<Event>& out);
+
+  private:
+	struct Snapshot {
+		std::int64_t mtime{};
+		std::uintmax_t size{};
+	};
+
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	using Listing = std::unordered_map<std::string, Snapshot, Hash, std::equal_to<>>;
+
+	void run(std::stop_token const& stop);
+	void push(std::string path, Kind kind);
+
+	void read_events();
+	void poll_directories();
+	[[nodiscard]] static auto list(std::string const& directory) -> Listing;
+
+	mutable std::mutex m_mutex{};
+	std::map<std::string, Kind, std::less<>> m_events{};
+	// inotify: directory <=> watch descriptor, polling: directory => last listing
+	std::unordered_map<std::string, int, Hash, std::equal_to<>> m_descriptors{};
+	std::unordered_map<int, std::string> m_directories{};
+	std::map<std::string, Listing, std::less<>> m_listings{};
+	std::condition_variable_any m_cv{};
+	int m_fd{-1};
+	// inotify ran out of watches: new directories are polled
+	bool m_watches_exhausted{};
+
+	// worker thread only: last directory polled, current tick interval
+	std::string m_poll_cursor{};
+	Clock::duration m_poll_interval{};
+	bool m_sweep_changed{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
@@ -0,0 +1,102 @@
+#include <file_writer.hpp>
+#include <log.hpp>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+#if defined(_WIN32)
+auto write_and_sync(std::string const& path, std::string_view const contents) -> bool {
+	auto file = std::ofstream{path, std::ios::binary | std::ios::trunc};
+	if (!file.is_open()) { return false; }
+	file.write(contents.data(), std::streamsize(contents.size()));
+	file.flush();
+	return file.good();
+}
+
+void sync_directory(fs::path const& /*directory*/) {}
+#else
+auto write_and_sync(std::string const& path, std::string_view contents) -> bool {
+	auto const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); // NOLINT
+	if (fd < 0) { return false; }
+	while (!contents.empty()) {
+		auto const written = ::write(fd, contents.data(), contents.size());
+		if (written < 0) {
+			if (errno == EINTR) { continue; }
+			::close(fd);
+			return false;
+		}
+		contents.remove_prefix(std::size_t(written));
+	}
+	auto const synced = ::fsync(fd) == 0;
+	return ::close(fd) == 0 && synced;
+}
+
+// makes the rename itself durable
+void sync_directory(fs::path const& directory) {
+	auto const fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); // NOLINT
+	if (fd < 0) { return; }
+	::fsync(fd);
+	::close(fd);
+}
+#endif
+} // namespace
+
+auto write_atomic(std::string const& path, std::string_view const contents) -> bool {
+	auto const temp = path + ".tmp";
+	auto ec = std::error_code{};
+	if (!write_and_sync(temp, contents)) {
+		fs::remove(temp, ec);
+		return false;
+	}
+	fs::rename(temp, path, ec);
+	if (ec) {
+		fs::remove(temp, ec);
+		return false;
+	}
+	sync_directory(fs::path{path}.parent_path());
+	return true;
+}
+
+FileWriter::FileWriter() {
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+void FileWriter::submit(std::string path, std::string contents) {
+	auto lock = std::scoped_lock{m_mutex};
+	m_pending.insert_or_assign(std::move(path), std::move(contents));
+	m_cv.notify_all();
+}
+
+void FileWriter::flush() {
+	auto lock = std::unique_lock{m_mutex};
+	m_cv.wait(lock, [this] { return m_pending.empty() && !m_busy; });
+}
+
+void FileWriter::run(std::stop_token const& stop) {
+	auto lock = std::unique_lock{m_mutex};
+	while (true) {
+		// keeps draining after a stop request so the last submitted contents are never lost
+		m_cv.wait(lock, stop, [this] { return !m_pending.empty(); });
+		if (m_pending.empty()) { return; }
+		auto const node = m_pending.extract(m_pending.begin());
+		m_busy = true;
+		lock.unlock();
+
+		if (!write_atomic(node.key(), node.mapped())) { log.warn("failed to write: {}", node.key()); }
+
+		lock.lock();
+		m_busy = false;
+		m_cv.notify_all();
+	}
+}
+} // namespace riff
@@ -0,0 +1,33 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace riff {
+// writes to a temporary file next to path, fsyncs it and renames it over path.
+auto write_atomic(std::string const& path, std::string_view contents) -> bool;
+
+// Atomic file writes on a background thread.
+// Only the latest contents submitted for a path are written, everything pending is written before destruction.
+class FileWriter : public klib::Pinned {
+  public:
+	FileWriter();
+
+	void submit(std::string path, std::string contents);
+	// blocks until all submitted writes have completed
+	void flush();
+
+  private:
+	void run(std::stop_token const& stop);
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::map<std::string, std::string, std::less<>> m_pending{};
+	bool m_busy{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
@@ -0,0 +1,159 @@
+#include <image.hpp>
+#include <algorithm>
+#include <array>
+
+#if defined(RIFF_JPEG)
+#include <csetjmp>
+// jpeglib.h needs FILE declared first
+#include <cstdio>
+#include <jpeglib.h>
+#endif
+
+#if defined(RIFF_PNG)
+#include <png.h>
+#endif
+
+namespace riff {
+namespace {
+using Bytes = std::span<std::byte const>;
+
+[[nodiscard]] auto starts_with(Bytes const bytes, std::span<std::uint8_t const> const magic) -> bool {
+	if (bytes.size() < magic.size()) { return false; }
+	return std::ranges::equal(bytes.first(magic.size()), magic, {}, {}, [](std::uint8_t b) { return std::byte(b); });
+}
+
+constexpr auto jpeg_magic_v = std::array<std::uint8_t, 3>{0xff, 0xd8, 0xff};
+constexpr auto png_magic_v = std::array<std::uint8_t, 8>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+// larger images are rejected rather than allocated: 8192 x 8192 RGBA is already 256 MiB
+constexpr std::uint32_t max_side_v{8192};
+
+[[nodiscard]] constexpr auto is_oversized(std::uint32_t const width, std::uint32_t const height) -> bool {
+	return width > max_side_v || height > max_side_v;
+}
+
+#if defined(RIFF_JPEG)
+struct JpegError {
+	jpeg_error_mgr manager{};
+	std::jmp_buf jump{};
+};
+
+// longjmp skips destructors: locals here must be trivially destructible, so the scanline is allocated from the
+// decompressor's own pool (freed by jpeg_destroy_decompress) and out is only written through a reference.
+auto decode_jpeg_to(Bitmap& out, Bytes const bytes, std::uint32_t const min_size) -> bool {
+	auto info = jpeg_decompress_struct{};
+	auto error = JpegError{};
+	info.err = jpeg_std_error(&error.manager);
+	error.manager.error_exit = [](j_common_ptr info) {
+		std::longjmp(reinterpret_cast<JpegError*>(info->err)->jump, 1); // NOLINT
+	};
+	error.manager.output_message = [](j_common_ptr /*info*/) {};
+	if (setjmp(error.jump) != 0) { // NOLINT(cert-err52-cpp)
+		jpeg_destroy_decompress(&info);
+		return false;
+	}
+
+	jpeg_create_decompress(&info);
+	jpeg_mem_src(&info, reinterpret_cast<unsigned char const*>(bytes.data()), bytes.size()); // NOLINT
+	jpeg_read_header(&info, TRUE);
+	info.out_color_space = JCS_RGB;
+	info.scale_num = 1;
+	info.scale_denom = 1;
+	if (min_size > 0) {
+		// DCT scaling: 1/2, 1/4 and 1/8 skip most of the decode work
+		auto const side = std::min(info.image_width, info.image_height);
+		while (info.scale_denom < 8 && side / (info.scale_denom * 2) >= min_size) { info.scale_denom *= 2; }
+	}
+	jpeg_start_decompress(&info);
+	if (is_oversized(info.output_width, info.output_height)) {
+		jpeg_destroy_decompress(&info);
+		return false;
+	}
+
+	out.width = info.output_width;
+	out.height = info.output_height;
+	out.pixels.resize(std::size_t(out.width) * out.height * 4);
+	auto* rows = (*info.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&info), JPOOL_IMAGE, out.width * 3, 1); // NOLINT
+	while (info.output_scanline < info.output_height) {
+		auto* dst = out.pixels.data() + std::size_t(info.output_scanline) * out.width * 4;
+		jpeg_read_scanlines(&info, rows, 1);
+		for (std::size_t x = 0; x < out.width; ++x) {
+			std::copy_n(rows[0] + (x * 3), 3, dst + (x * 4));
+			dst[(x * 4) + 3] = 0xff;
+		}
+	}
+	jpeg_finish_decompress(&info);
+	jpeg_destroy_decompress(&info);
+	return true;
+}
+#endif
+
+[[nodiscard]] auto decode_jpeg([[maybe_unused]] Bytes const bytes, [[maybe_unused]] std::uint32_t const min_size)
+	-> std::optional<Bitmap> {
+#if defined(RIFF_JPEG)
+	auto ret = Bitmap{};
+	if (decode_jpeg_to(ret, bytes, min_size)) { return ret; }
+#endif
+	return {};
+}
+
+[[nodiscard]] auto decode_png([[maybe_unused]] Bytes const bytes) -> std::optional<Bitmap> {
+#if defined(RIFF_PNG)
+	auto image = png_image{};
+	image.version = PNG_IMAGE_VERSION;
+	if (png_image_begin_read_from_memory(&image, bytes.data(), bytes.size()) == 0) { return {}; }
+	if (is_oversized(image.width, image.height)) {
+		png_image_free(&image);
+		return {};
+	}
+	image.format = PNG_FORMAT_RGBA;
+	auto ret = Bitmap{.width = image.width, .height = image.height};
+	ret.pixels.resize(PNG_IMAGE_SIZE(image));
+	// frees image on failure as well as success
+	if (png_image_finish_read(&image, nullptr, ret.pixels.data(), 0, nullptr) == 0) { return {}; }
+	return ret;
+#else
+	return {};
+#endif
+}
+} // namespace
+
+auto decode_image(Bytes const bytes, std::uint32_t const min_size) -> std::optional<Bitmap> {
+	if (starts_with(bytes, jpeg_magic_v)) { return decode_jpeg(bytes, min_size); }
+	if (starts_with(bytes, png_magic_v)) { return decode_png(bytes); }
+	return {};
+}
+
+auto make_thumbnail(Bitmap const& source, std::uint32_t const size) -> Bitmap {
+	if (source.is_empty() || size == 0) { return {}; }
+	auto const side = std::min(source.width, source.height);
+	auto const left = (source.width - side) / 2;
+	auto const top = (source.height - side) / 2;
+	auto ret = Bitmap{.width = size, .height = size};
+	ret.pixels.resize(std::size_t(size) * size * 4);
+
+	// source span of output cell i, at least one pixel wide when upscaling
+	auto const span = [side, size](std::uint32_t const i) {
+		auto const first = i * side / size;
+		auto const last = std::max((i + 1) * side / size, first + 1);
+		return std::pair{first, last};
+	};
+	for (std::uint32_t y = 0; y < size; ++y) {
+		auto const [y0, y1] = span(y);
+		for (std::uint32_t x = 0; x < size; ++x) {
+			auto const [x0, x1] = span(x);
+			auto sum = std::array<std::uint32_t, 4>{};
+			for (auto sy = y0; sy < y1; ++sy) {
+				auto const* row = source.pixels.data() + (std::size_t(top + sy) * source.width + left) * 4;
+				for (auto sx = x0; sx < x1; ++sx) {
+					for (std::size_t c = 0; c < 4; ++c) { sum.at(c) += row[(sx * 4) + c]; }
+				}
+			}
+			auto const count = (y1 - y0) * (x1 - x0);
+			auto* dst = ret.pixels.data() + (std::size_t(y) * size + x) * 4;
+			for (std::size_t c = 0; c < 4; ++c) { dst[c] = std::uint8_t(sum.at(c) / count); }
+		}
+	}
+	return ret;
+}
+} // namespace riff
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace riff {
+// 8 bit RGBA, rows top to bottom.
+struct Bitmap {
+	[[nodiscard]] auto is_empty() const -> bool { return width == 0 || height == 0; }
+
+	std::uint32_t width{};
+	std::uint32_t height{};
+	std::vector<std::uint8_t> pixels{};
+};
+
+// JPEG and PNG, when built with libjpeg (RIFF_JPEG) and libpng (RIFF_PNG).
+// JPEGs are scaled while decoding, to the smallest size that still covers min_size.
+// Images wider or taller than 8192 pixels (after scaling) are rejected.
+[[nodiscard]] auto decode_image(std::span<std::byte const> bytes, std::uint32_t min_size = 0) -> std::optional<Bitmap>;
+
+// centre cropped to a square and box filtered to size x size.
+[[nodiscard]] auto make_thumbnail(Bitmap const& source, std::uint32_t size) -> Bitmap;
+} // namespace riff
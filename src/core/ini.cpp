@@ -0,0 +1,206 @@
+#include <file_writer.hpp>
+#include <ini.hpp>
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <fstream>
+
+namespace riff {
+namespace {
+constexpr auto trim_front(std::string_view in) {
+	while (!in.empty() && std::isspace(static_cast<unsigned char>(in.front())) != 0) { in = in.substr(1); }
+	return in;
+}
+
+constexpr auto trim_back(std::string_view in) {
+	while (!in.empty() && std::isspace(static_cast<unsigned char>(in.back())) != 0) {
+		in = in.substr(0, in.size() - 1);
+	}
+	return in;
+}
+
+constexpr auto trim(std::string_view const in) { return trim_front(trim_back(in)); }
+} // namespace
+
+auto Ini::load(klib::CString const path) -> bool {
+	auto file = std::ifstream{path.c_str(), std::ios::binary | std::ios::ate};
+	if (!file) { return false; }
+	auto const size = file.tellg();
+	if (size < 0) { return false; }
+	auto buffer = std::vector<char>(std::size_t(size));
+	file.seekg(0);
+	if (!file.read(buffer.data(), size)) { return false; }
+	*this = Ini{};
+	m_buffer = std::move(buffer);
+	parse_buffer();
+	return true;
+}
+
+auto Ini::save(klib::CString const path) const -> bool { return write_atomic(path.c_str(), serialize()); }
+
+void Ini::parse(std::string_view const text) {
+	*this = Ini{};
+	m_buffer.assign(text.begin(), text.end());
+	parse_buffer();
+}
+
+auto Ini::serialize() const -> std::string {
+	auto ret = std::string{};
+	ret.reserve(m_buffer.size() + 64);
+	auto out = std::back_inserter(ret);
+	auto const write = [&](Line const& line) {
+		if (line.removed) { return; }
+		if (line.changed) {
+			std::format_to(out, "{} = {}\n", line.key, *line.changed);
+		} else if (line.raw.empty() && line.kind == Kind::Section) {
+			std::format_to(out, "[{}]\n", line.section);
+		} else {
+			std::format_to(out, "{}\n", line.raw);
+		}
+	};
+	// set_value appends: merge inserted lines by anchor, keeping the order they were added in
+	auto inserted = m_inserted;
+	std::ranges::stable_sort(inserted, {}, &Inserted::anchor);
+	auto next = inserted.begin();
+	for (std::uint32_t position = 0; position <= m_order.size(); ++position) {
+		for (; next != inserted.end() && next->anchor == position; ++next) { write(m_lines.at(next->line)); }
+		if (position < m_order.size()) { write(m_lines.at(m_order.at(position))); }
+	}
+	return ret;
+}
+
+void Ini::parse_buffer() {
+	auto remain = std::string_view{m_buffer.data(), m_buffer.size()};
+	auto section = std::string_view{};
+	while (!remain.empty()) {
+		auto const newline = remain.find('\n');
+		auto raw = remain.substr(0, newline);
+		remain = newline == std::string_view::npos ? std::string_view{} : remain.substr(newline + 1);
+		if (raw.ends_with('\r')) { raw.remove_suffix(1); }
+
+		auto line = Line{.raw = raw};
+		auto const trimmed = trim(raw);
+		auto const eq = trimmed.find('=');
+		if (trimmed.starts_with('[') && trimmed.ends_with(']')) {
+			section = trim(trimmed.substr(1, trimmed.size() - 2));
+			line.kind = Kind::Section;
+			line.section = section;
+		} else if (!trimmed.starts_with('#') && !trimmed.starts_with(';') && eq != std::string_view::npos) {
+			line.kind = Kind::Value;
+			line.section = section;
+			line.key = trim_back(trimmed.substr(0, eq));
+			line.value = trim_front(trimmed.substr(eq + 1));
+		}
+		auto const index = push_line(line);
+		m_order.push_back(index);
+		if (line.kind != Kind::Value || line.key.empty()) { continue; }
+		m_entries.push_back(Entry{.section = line.section, .key = line.key, .line = index});
+	}
+
+	// new keys go after the last line of their section (global keys before the first section)
+	auto in_section = std::string_view{};
+	for (std::uint32_t i = 0; i < m_order.size(); ++i) {
+		auto const& line = m_lines.at(m_order.at(i));
+		if (line.kind == Kind::Section) {
+			if (m_anchors.empty()) { m_anchors.push_back(Anchor{.position = i}); }
+			in_section = line.section;
+		} else if (line.kind != Kind::Value) {
+			continue;
+		}
+		auto const it = std::ranges::find(m_anchors, in_section, &Anchor::section);
+		if (it == m_anchors.end()) {
+			m_anchors.push_back(Anchor{.section = in_section, .position = i + 1});
+		} else {
+			it->position = i + 1;
+		}
+	}
+
+	// duplicate keys: the last one wins
+	std::ranges::stable_sort(m_entries);
+	auto out = m_entries.begin();
+	for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+		if (out != m_entries.begin() && *std::prev(out) == *it) {
+			m_lines.at(std::prev(out)->line).removed = true;
+			*std::prev(out) = *it;
+			continue;
+		}
+		*out++ = *it;
+	}
+	m_entries.erase(out, m_entries.end());
+}
+
+auto Ini::get_value(Key const& key, std::string_view const fallback) const -> std::string_view {
+	auto const* entry = find(key);
+	if (entry == nullptr) { return fallback; }
+	return value_of(*entry);
+}
+
+void Ini::set_value(Key const& key, std::string_view const value) {
+	if (auto const* entry = find(key)) {
+		auto& line = m_lines.at(entry->line);
+		if (value_of(*entry) != value) { line.changed = std::string{value}; }
+		return;
+	}
+
+	auto const section = intern(key.section);
+	auto line = Line{.kind = Kind::Value, .section = section, .key = intern(key.name), .changed = std::string{value}};
+	auto const entry = Entry{.section = section, .key = line.key};
+	auto const anchor = get_anchor(section);
+	auto const index = push_line(std::move(line));
+	m_inserted.push_back(Inserted{.anchor = anchor, .line = index});
+	m_entries.insert(std::ranges::upper_bound(m_entries, entry), Entry{entry.section, entry.key, index});
+}
+
+void Ini::remove(Key const& key) {
+	auto const it = lower_bound(key);
+	if (it == m_entries.end() || it->section != key.section || it->key != key.name) { return; }
+	m_lines.at(it->line).removed = true;
+	m_entries.erase(it);
+}
+
+auto Ini::lower_bound(Key const& key) const -> std::vector<Entry>::const_iterator {
+	return std::ranges::lower_bound(m_entries, Entry{.section = key.section, .key = key.name});
+}
+
+auto Ini::find(Key const& key) const -> Entry const* {
+	auto const it = lower_bound(key);
+	if (it == m_entries.end() || it->section != key.section || it->key != key.name) { return nullptr; }
+	return &*it;
+}
+
+auto Ini::value_of(Entry const& entry) const -> std::string_view {
+	auto const& line = m_lines.at(entry.line);
+	if (line.changed) { return *line.changed; }
+	return line.value;
+}
+
+auto Ini::intern(std::string_view const text) -> std::string_view {
+	if (text.empty()) { return {}; }
+	return m_strings.emplace_back(text);
+}
+
+// creates the section at the end if it doesn't exist
+auto Ini::get_anchor(std::string_view const section) -> std::uint32_t {
+	if (auto const it = std::ranges::find(m_anchors, section, &Anchor::section); it != m_anchors.end()) {
+		return it->position;
+	}
+	auto const end = std::uint32_t(m_order.size());
+	// global keys must precede the first section: sections are only ever appended, so this stays valid
+	if (section.empty()) { return m_anchors.emplace_back(Anchor{.position = end}).position; }
+	if (m_anchors.empty()) { m_anchors.push_back(Anchor{.position = end}); }
+	auto const ends_blank = [&] {
+		if (std::ranges::any_of(m_inserted, [end](Inserted const& i) { return i.anchor == end; })) { return false; }
+		auto const& last = m_lines.at(m_order.back());
+		return last.kind == Kind::Other && trim(last.raw).empty();
+	};
+	if (!m_order.empty() && !ends_blank()) { m_order.push_back(push_line(Line{.raw = {}})); }
+	m_order.push_back(push_line(Line{.kind = Kind::Section, .section = section}));
+	return m_anchors.emplace_back(Anchor{.section = section, .position = std::uint32_t(m_order.size())}).position;
+}
+
+auto Ini::push_line(Line line) -> std::uint32_t {
+	auto const ret = std::uint32_t(m_lines.size());
+	m_lines.push_back(std::move(line));
+	return ret;
+}
+} // namespace riff
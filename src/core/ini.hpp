@@ -0,0 +1,129 @@
+#pragma once
+#include <klib/c_string.hpp>
+#include <klib/concepts.hpp>
+#include <charconv>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace riff {
+// Section aware INI document over a single read buffer.
+// Lookups go through a flat map sorted by (section, key), saving preserves comments, unknown lines and ordering.
+class Ini {
+  public:
+	struct Key {
+		Key(char const* name) : name(name) {} // NOLINT(google-explicit-constructor)
+		Key(std::string_view const name) : name(name) {} // NOLINT(google-explicit-constructor)
+		Key(std::string const& name) : name(name) {} // NOLINT(google-explicit-constructor)
+		Key(std::string_view const section, std::string_view const name) : section(section), name(name) {}
+
+		std::string_view section{};
+		std::string_view name{};
+	};
+
+	Ini() = default;
+	Ini(Ini const&) = delete;
+	Ini(Ini&&) = default;
+	auto operator=(Ini const&) -> Ini& = delete;
+	auto operator=(Ini&&) -> Ini& = default;
+	~Ini() = default;
+
+	[[nodiscard]] auto load(klib::CString path) -> bool;
+	[[nodiscard]] auto save(klib::CString path) const -> bool;
+
+	void parse(std::string_view text);
+	[[nodiscard]] auto serialize() const -> std::string;
+
+	[[nodiscard]] auto get_value(Key const& key, std::string_view fallback = {}) const -> std::string_view;
+
+	auto assign_to(std::string& out, Key const& key) const -> bool {
+		auto const value = get_value(key);
+		if (value.empty()) { return false; }
+		out = value;
+		return true;
+	}
+
+	auto assign_to(bool& out, Key const& key) const -> bool {
+		auto const value = get_value(key);
+		if (value != "true" && value != "false") { return false; }
+		out = value == "true";
+		return true;
+	}
+
+	template <klib::NumberT Type>
+	auto assign_to(Type& out, Key const& key) const -> bool {
+		auto const value = get_value(key);
+		if (value.empty()) { return false; }
+		auto const* end = value.data() + value.size();
+		auto const [ptr, ec] = std::from_chars(value.data(), end, out);
+		return ec == std::errc{} && ptr == end;
+	}
+
+	void set_value(Key const& key, std::string_view value);
+	void remove(Key const& key);
+
+	// func(key, value) for each key in section, in key order
+	template <typename F>
+	void for_each(std::string_view const section, F func) const {
+		for (auto it = lower_bound({section, {}}); it != m_entries.end() && it->section == section; ++it) {
+			func(it->key, value_of(*it));
+		}
+	}
+
+  private:
+	enum class Kind : std::int8_t { Other, Section, Value };
+
+	struct Line {
+		Kind kind{};
+		std::string_view raw{};
+		std::string_view section{};
+		std::string_view key{};
+		std::string_view value{};
+		std::optional<std::string> changed{};
+		bool removed{};
+	};
+
+	struct Entry {
+		std::string_view section{};
+		std::string_view key{};
+		std::uint32_t line{};
+
+		auto operator==(Entry const& rhs) const -> bool { return section == rhs.section && key == rhs.key; }
+		auto operator<=>(Entry const& rhs) const {
+			if (auto const ret = section <=> rhs.section; ret != 0) { return ret; }
+			return key <=> rhs.key;
+		}
+	};
+
+	// a line added by set_value, serialized before m_order[anchor] (or at the end if anchor == m_order.size())
+	struct Inserted {
+		std::uint32_t anchor{};
+		std::uint32_t line{};
+	};
+
+	// m_order position that new keys of section are inserted at
+	struct Anchor {
+		std::string_view section{};
+		std::uint32_t position{};
+	};
+
+	void parse_buffer();
+
+	[[nodiscard]] auto lower_bound(Key const& key) const -> std::vector<Entry>::const_iterator;
+	[[nodiscard]] auto find(Key const& key) const -> Entry const*;
+	[[nodiscard]] auto value_of(Entry const& entry) const -> std::string_view;
+	[[nodiscard]] auto intern(std::string_view text) -> std::string_view;
+	[[nodiscard]] auto get_anchor(std::string_view section) -> std::uint32_t;
+	auto push_line(Line line) -> std::uint32_t;
+
+	std::vector<char> m_buffer{};
+	std::deque<std::string> m_strings{};
+	std::vector<Line> m_lines{};
+	std::vector<std::uint32_t> m_order{};
+	std::vector<Inserted> m_inserted{};
+	std::vector<Anchor> m_anchors{};
+	std::vector<Entry> m_entries{};
+};
+} // namespace riff
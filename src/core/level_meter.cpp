@@ -0,0 +1,45 @@
+#include <level_meter.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace riff {
+auto LevelMeter::get_level(std::size_t const channel) const -> Level {
+	if (channel >= get_channels()) { return {}; }
+	return Level{
+		.peak = m_peak.at(channel).load(std::memory_order_relaxed),
+		.rms = m_rms.at(channel).load(std::memory_order_relaxed),
+	};
+}
+
+void LevelMeter::write(std::span<float const> const interleaved, std::uint8_t const channels,
+					   std::uint32_t /*sample_rate*/) {
+	if (channels == 0) { return; }
+	auto const frames = interleaved.size() / channels;
+	if (frames == 0) { return; }
+
+	// frames keep their full stride, only the first max_channels_v channels are metered
+	auto const meters = std::min(channels, std::uint8_t(max_channels_v));
+	auto peak = std::array<float, max_channels_v>{};
+	auto sum = std::array<float, max_channels_v>{};
+	for (std::size_t f = 0; f < frames; ++f) {
+		auto const frame = interleaved.subspan(f * channels, channels);
+		for (std::size_t c = 0; c < meters; ++c) {
+			peak[c] = std::max(peak[c], std::abs(frame[c]));
+			sum[c] += frame[c] * frame[c];
+		}
+	}
+
+	for (std::size_t c = 0; c < meters; ++c) {
+		m_peak.at(c).store(peak[c], std::memory_order_relaxed);
+		m_rms.at(c).store(std::sqrt(sum[c] / float(frames)), std::memory_order_relaxed);
+	}
+	m_channels.store(meters, std::memory_order_relaxed);
+}
+
+void LevelMeter::reset() {
+	for (std::size_t c = 0; c < max_channels_v; ++c) {
+		m_peak.at(c).store(0.0f, std::memory_order_relaxed);
+		m_rms.at(c).store(0.0f, std::memory_order_relaxed);
+	}
+}
+} // namespace riff
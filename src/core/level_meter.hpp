@@ -0,0 +1,27 @@
+#pragma once
+#include <pcm_tap.hpp>
+#include <array>
+#include <atomic>
+
+namespace riff {
+class LevelMeter : public PcmTap::ISink {
+  public:
+	static constexpr std::size_t max_channels_v{8};
+
+	struct Level {
+		float peak{};
+		float rms{};
+	};
+
+	[[nodiscard]] auto get_channels() const -> std::uint8_t { return m_channels.load(std::memory_order_relaxed); }
+	[[nodiscard]] auto get_level(std::size_t channel) const -> Level;
+
+	void write(std::span<float const> interleaved, std::uint8_t channels, std::uint32_t sample_rate) final;
+	void reset() final;
+
+  private:
+	std::array<std::atomic<float>, max_channels_v> m_peak{};
+	std::array<std::atomic<float>, max_channels_v> m_rms{};
+	std::atomic<std::uint8_t> m_channels{};
+};
+} // namespace riff
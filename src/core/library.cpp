@@ -0,0 +1,295 @@
+#include <binary_io.hpp>
+#include <file_type.hpp>
+#include <file_writer.hpp>
+#include <library.hpp>
+#include <log.hpp>
+#include <tag_reader.hpp>
+#include <time.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr auto magic_v = std::string_view{"riff-library"};
+constexpr std::uint32_t version_v{2};
+
+void write(BinaryWriter& writer, Library::Entry const& entry) {
+	writer.write(entry.path);
+	writer.write(entry.size);
+	writer.write(entry.mtime);
+	writer.write(std::int8_t(entry.info.format));
+	writer.write(entry.info.duration.count());
+	writer.write(entry.info.sample_rate);
+	writer.write(entry.info.channels);
+	writer.write(entry.tags.title);
+	writer.write(entry.tags.artist);
+	writer.write(entry.tags.album);
+	writer.write(entry.tags.track_number);
+}
+
+auto read(BinaryReader& reader, Library::Entry& out) -> bool {
+	auto format = std::int8_t{};
+	auto duration = float{};
+	reader.read(out.path);
+	reader.read(out.size);
+	reader.read(out.mtime);
+	reader.read(format);
+	reader.read(duration);
+	reader.read(out.info.sample_rate);
+	reader.read(out.info.channels);
+	reader.read(out.tags.title);
+	reader.read(out.tags.artist);
+	reader.read(out.tags.album);
+	reader.read(out.tags.track_number);
+	if (!reader.is_ok() || format < 0 || format >= std::int8_t(AudioFormat::COUNT_)) { return false; }
+	out.info.format = AudioFormat(format);
+	out.info.duration = Time{duration};
+	return true;
+}
+
+[[nodiscard]] auto serialize(Library::Index const& index) -> std::string {
+	auto ret = std::string{magic_v};
+	auto writer = BinaryWriter{ret};
+	writer.write(version_v);
+	writer.write(std::uint64_t(index.size()));
+	for (auto const& entry : index) { write(writer, entry); }
+	return ret;
+}
+
+[[nodiscard]] auto deserialize(std::string_view text, Library::Index& out) -> bool {
+	if (!text.starts_with(magic_v)) { return false; }
+	auto reader = BinaryReader{text.substr(magic_v.size())};
+	auto version = std::uint32_t{};
+	auto count = std::uint64_t{};
+	if (!reader.read(version) || version != version_v || !reader.read(count)) { return false; }
+	out.clear();
+	out.reserve(std::size_t(std::min<std::uint64_t>(count, text.size())));
+	for (std::uint64_t i = 0; i < count; ++i) {
+		if (!read(reader, out.emplace_back())) { return false; }
+	}
+	return std::ranges::is_sorted(out, {}, &Library::Entry::path);
+}
+
+void push_if_music(Library::Index& out, fs::directory_entry const& entry) {
+	auto ec = std::error_code{};
+	auto const extension = entry.path().extension().generic_string();
+	if (!entry.is_regular_file(ec) || get_file_type(extension) != FileType::Music) { return; }
+	out.push_back(Library::Entry{
+		.path = entry.path().generic_string(),
+		.size = entry.file_size(ec),
+		.mtime = entry.last_write_time(ec).time_since_epoch().count(),
+	});
+}
+
+// walks every root (a directory or a single file), collecting music files with their size and mtime
+[[nodiscard]] auto walk(std::stop_token const& stop, std::span<std::string const> roots) -> Library::Index {
+	auto ret = Library::Index{};
+	for (auto const& root : roots) {
+		auto ec = std::error_code{};
+		if (fs::is_regular_file(root, ec)) {
+			push_if_music(ret, fs::directory_entry{root, ec});
+			continue;
+		}
+		auto it = fs::recursive_directory_iterator{root, fs::directory_options::skip_permission_denied, ec};
+		for (; !ec && it != fs::recursive_directory_iterator{}; it.increment(ec)) {
+			if (stop.stop_requested()) { return {}; }
+			push_if_music(ret, *it);
+		}
+	}
+	std::ranges::sort(ret, {}, &Library::Entry::path);
+	auto const [first, last] = std::ranges::unique(ret, {}, &Library::Entry::path);
+	ret.erase(first, last);
+	return ret;
+}
+
+// path is root itself or inside it
+[[nodiscard]] auto is_within(std::string_view const path, std::string_view const root) -> bool {
+	if (!path.starts_with(root)) { return false; }
+	return path.size() == root.size() || path[root.size()] == '/' || root.ends_with('/');
+}
+
+struct ScanningFlag {
+	ScanningFlag(ScanningFlag const&) = delete;
+	ScanningFlag(ScanningFlag&&) = delete;
+	auto operator=(ScanningFlag const&) = delete;
+	auto operator=(ScanningFlag&&) = delete;
+
+	explicit ScanningFlag(std::atomic<bool>& flag) : flag(flag) { flag = true; }
+	~ScanningFlag() { flag = false; }
+
+	std::atomic<bool>& flag;
+};
+} // namespace
+
+auto Library::load() -> bool {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return false; }
+	auto const text = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	auto index = Index{};
+	if (!deserialize(text, index)) {
+		log.warn("ignoring invalid library index: {}", path);
+		return false;
+	}
+	log.info("loaded library index ({} files) from: {}", index.size(), path);
+	publish(std::make_shared<Index const>(std::move(index)));
+	return true;
+}
+
+Library::Library() {
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+void Library::rescan(std::vector<std::string> roots) {
+	auto lock = std::scoped_lock{m_mutex};
+	m_rescan = std::move(roots);
+	m_events.clear();
+	m_cv.notify_one();
+}
+
+void Library::update(std::span<FileWatcher::Event const> const events) {
+	if (events.empty()) { return; }
+	auto lock = std::scoped_lock{m_mutex};
+	m_events.insert(m_events.end(), events.begin(), events.end());
+	m_cv.notify_one();
+}
+
+auto Library::get_index() const -> std::shared_ptr<Index const> {
+	auto lock = std::scoped_lock{m_mutex};
+	return m_index;
+}
+
+auto Library::get_directories() const -> std::shared_ptr<Directories const> {
+	auto lock = std::scoped_lock{m_mutex};
+	return m_directories;
+}
+
+void Library::run(std::stop_token const& stop) {
+	auto const has_work = [this] { return m_rescan || !m_events.empty(); };
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (m_save_at) {
+			if (!m_cv.wait_until(lock, stop, *m_save_at, has_work)) {
+				lock.unlock();
+				save();
+				continue;
+			}
+		} else if (!m_cv.wait(lock, stop, has_work)) {
+			break;
+		}
+		auto const flag = ScanningFlag{m_scanning};
+		if (m_rescan) {
+			m_roots = std::move(*m_rescan);
+			m_rescan.reset();
+			lock.unlock();
+			scan(stop);
+			continue;
+		}
+		auto events = std::exchange(m_events, {});
+		lock.unlock();
+		apply(stop, std::move(events));
+	}
+	// updates still waiting for their save
+	if (m_save_at) { save(); }
+}
+
+void Library::scan(std::stop_token const& stop) {
+	auto const start = Clock::now();
+	auto index = walk(stop, m_roots);
+	if (stop.stop_requested()) { return; }
+	commit(stop, std::move(index), "scan", start);
+	if (!stop.stop_requested()) { save(); }
+}
+
+void Library::apply(std::stop_token const& stop, std::vector<FileWatcher::Event> events) {
+	std::erase_if(events, [this](FileWatcher::Event const& event) {
+		return std::ranges::none_of(m_roots, [&event](std::string const& root) { return is_within(event.path, root); });
+	});
+	if (events.empty()) { return; }
+	auto const start = Clock::now();
+
+	// drop everything at or below an event path, then walk the paths that still exist
+	auto const is_affected = [&events](Entry const& entry) {
+		return std::ranges::any_of(events, [&entry](FileWatcher::Event const& e) { return is_within(entry.path, e.path); });
+	};
+	auto index = Index{};
+	std::ranges::copy_if(*get_index(), std::back_inserter(index), [&](Entry const& e) { return !is_affected(e); });
+	auto changed = std::vector<std::string>{};
+	for (auto& event : events) {
+		if (event.kind == FileWatcher::Kind::Changed) { changed.push_back(std::move(event.path)); }
+	}
+	auto fresh = walk(stop, changed);
+	if (stop.stop_requested()) { return; }
+	// both halves are sorted already
+	auto const middle =
+		index.insert(index.end(), std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+	std::ranges::inplace_merge(index, middle, {}, &Entry::path);
+	auto const [first, last] = std::ranges::unique(index, {}, &Entry::path);
+	index.erase(first, last);
+	commit(stop, std::move(index), "update", start);
+	if (!m_save_at) { m_save_at = Clock::now() + save_delay_v; }
+}
+
+// reuses the previous entries of unchanged files, probes the rest, then publishes index
+void Library::commit(std::stop_token const& stop, Index index, std::string_view const label,
+					 Clock::time_point const start) {
+	auto const previous = get_index();
+	auto pending = std::vector<std::size_t>{};
+	for (std::size_t i = 0; i < index.size(); ++i) {
+		auto& entry = index.at(i);
+		auto const it = std::ranges::lower_bound(*previous, entry.path, {}, &Entry::path);
+		if (it != previous->end() && it->path == entry.path && it->size == entry.size && it->mtime == entry.mtime) {
+			entry = *it;
+			continue;
+		}
+		pending.push_back(i);
+	}
+
+	auto next = std::atomic<std::size_t>{};
+	auto const probe = [&] {
+		for (auto i = next++; i < pending.size() && !stop.stop_requested(); i = next++) {
+			auto& entry = index.at(pending.at(i));
+			if (auto const info = probe_media(entry.path)) { entry.info = *info; }
+			if (auto tags = read_tags(entry.path)) { entry.tags = std::move(*tags); }
+		}
+	};
+	{
+		static constexpr std::size_t batch_v{32};
+		auto const cores = std::max(std::thread::hardware_concurrency(), 1u);
+		auto const threads = std::clamp<std::size_t>(pending.size() / batch_v, 1, cores);
+		auto workers = std::vector<std::jthread>{};
+		for (std::size_t i = 1; i < threads; ++i) { workers.emplace_back(probe); }
+		probe();
+	}
+	if (stop.stop_requested()) { return; }
+
+	auto const count = index.size();
+	publish(std::make_shared<Index const>(std::move(index)));
+	auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+	log.info("library {}: {} files, {} probed, {}ms", label, count, pending.size(), elapsed.count());
+}
+
+void Library::publish(std::shared_ptr<Index const> index) {
+	auto directories = Directories{};
+	for (auto const& entry : *index) {
+		auto const parent = std::string_view{entry.path}.substr(0, entry.path.find_last_of('/'));
+		if (directories.empty() || directories.back() != parent) { directories.emplace_back(parent); }
+	}
+	std::ranges::sort(directories);
+	auto const [first, last] = std::ranges::unique(directories);
+	directories.erase(first, last);
+
+	auto lock = std::scoped_lock{m_mutex};
+	m_index = std::move(index);
+	m_directories = std::make_shared<Directories const>(std::move(directories));
+}
+
+void Library::save() {
+	m_save_at.reset();
+	if (!write_atomic(path, serialize(*get_index()))) { log.warn("failed to save library index to: {}", path); }
+}
+} // namespace riff
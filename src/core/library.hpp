@@ -0,0 +1,76 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <file_watcher.hpp>
+#include <media_probe.hpp>
+#include <tags.hpp>
+#include <time.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace riff {
+// Persistent index of the music files under a set of root directories.
+// Rescans and watcher updates run on a background thread: unchanged files (same size and mtime) are reused,
+// the rest are probed in parallel across cores.
+// A rescan saves the index right away, watcher updates are saved at most once every save_delay_v.
+class Library : public klib::Pinned {
+  public:
+	static constexpr auto save_delay_v{5s};
+
+	struct Entry {
+		std::string path{};
+		std::uint64_t size{};
+		std::int64_t mtime{};
+		MediaInfo info{};
+		Tags tags{};
+	};
+
+	// sorted by path
+	using Index = std::vector<Entry>;
+	// parent directories of indexed files, sorted and unique
+	using Directories = std::vector<std::string>;
+
+	Library();
+
+	auto load() -> bool;
+	// a rescan supersedes any pending updates
+	void rescan(std::vector<std::string> roots);
+	// updates only the given paths (files or directories), ignoring those outside the roots of the last rescan
+	void update(std::span<FileWatcher::Event const> events);
+
+	[[nodiscard]] auto is_scanning() const -> bool { return m_scanning.load(); }
+	[[nodiscard]] auto get_index() const -> std::shared_ptr<Index const>;
+	// published along with the index, built on the worker thread
+	[[nodiscard]] auto get_directories() const -> std::shared_ptr<Directories const>;
+
+	std::string path{"riff.library"};
+
+  private:
+	void run(std::stop_token const& stop);
+	void scan(std::stop_token const& stop);
+	void apply(std::stop_token const& stop, std::vector<FileWatcher::Event> events);
+	void commit(std::stop_token const& stop, Index index, std::string_view label, Clock::time_point start);
+	void publish(std::shared_ptr<Index const> index);
+	void save();
+
+	mutable std::mutex m_mutex{};
+	std::shared_ptr<Index const> m_index{std::make_shared<Index const>()};
+	std::shared_ptr<Directories const> m_directories{std::make_shared<Directories const>()};
+	std::optional<std::vector<std::string>> m_rescan{};
+	std::vector<FileWatcher::Event> m_events{};
+	std::condition_variable_any m_cv{};
+	std::atomic<bool> m_scanning{};
+
+	// worker thread only
+	std::vector<std::string> m_roots{};
+	std::optional<Clock::time_point> m_save_at{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
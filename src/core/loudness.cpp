@@ -0,0 +1,208 @@
+#include <loudness.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+namespace riff {
+namespace {
+constexpr auto block_steps_v = std::size_t{4};
+constexpr auto relative_gate_v = 0.1; // -10 LU
+constexpr auto oversample_below_v = std::uint32_t{96000};
+// histogram bins span [silence_v, +20) LUFS
+constexpr auto histogram_bins_v = std::size_t{900};
+
+// ITU-R BS.1770-4 Annex 2: 4x polyphase interpolation filter, 12 taps per phase.
+constexpr auto true_peak_taps_v = std::array<std::array<float, 12>, 4>{{
+	{0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+	 0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+	{-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+	 0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+	{-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+	 0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+	{-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+	 0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f},
+}};
+
+[[nodiscard]] auto to_lufs(double const energy) -> float { return float(-0.691 + (10.0 * std::log10(energy))); }
+
+[[nodiscard]] auto from_lufs(double const lufs) -> double { return std::pow(10.0, (lufs + 0.691) / 10.0); }
+
+// BS.1770 K-weighting, generalized to any sample rate (pre-filter high shelf + RLB high pass).
+[[nodiscard]] auto k_tan(double const f0, std::uint32_t const sample_rate) {
+	return std::tan(std::numbers::pi * f0 / double(sample_rate));
+}
+} // namespace
+
+auto Loudness::to_gain_db() const -> float {
+	if (integrated <= silence_v) { return 0.0f; }
+	auto ret = reference_v - integrated;
+	if (true_peak > 0.0f) { ret = std::min(ret, -20.0f * std::log10(true_peak)); }
+	return ret;
+}
+
+LoudnessMeter::LoudnessMeter(std::uint32_t const sample_rate, std::uint8_t const channels)
+	: m_stride(channels), m_channels(std::min(channels, std::uint8_t(max_channels_v))), m_step_frames(sample_rate / 10),
+	  m_oversample(sample_rate < oversample_below_v) {
+	assert(sample_rate > 0 && channels > 0);
+
+	{
+		static constexpr auto f0 = 1681.974450955533;
+		static constexpr auto gain_db = 3.999843853973347;
+		static constexpr auto q = 0.7071752369554196;
+		auto const k = k_tan(f0, sample_rate);
+		auto const vh = std::pow(10.0, gain_db / 20.0);
+		auto const vb = std::pow(vh, 0.4996667741545416);
+		auto const a0 = 1.0 + (k / q) + (k * k);
+		m_shelf.b = {float((vh + (vb * k / q) + (k * k)) / a0), float(2.0 * ((k * k) - vh) / a0),
+					 float((vh - (vb * k / q) + (k * k)) / a0)};
+		m_shelf.a = {float(2.0 * ((k * k) - 1.0) / a0), float((1.0 - (k / q) + (k * k)) / a0)};
+	}
+	{
+		static constexpr auto f0 = 38.13547087602444;
+		static constexpr auto q = 0.5003270373238773;
+		auto const k = k_tan(f0, sample_rate);
+		auto const a0 = 1.0 + (k / q) + (k * k);
+		m_highpass.b = {1.0f, -2.0f, 1.0f};
+		m_highpass.a = {float(2.0 * ((k * k) - 1.0) / a0), float((1.0 - (k / q) + (k * k)) / a0)};
+	}
+
+	// 5.1 layout: L R C LFE Ls Rs; LFE is excluded and surrounds are weighted +1.5 dB.
+	for (std::size_t c = 0; c < m_channels; ++c) {
+		if (m_channels < 6) {
+			m_weights.at(c) = 1.0f;
+			continue;
+		}
+		m_weights.at(c) = c == 3 ? 0.0f : (c >= 4 ? 1.41f : 1.0f);
+	}
+}
+
+void LoudnessMeter::process(std::span<float const> const interleaved) {
+	if (m_step_frames == 0) { return; }
+	if (m_channels <= 2) {
+		process_lanes<2>(interleaved);
+	} else {
+		process_lanes<max_channels_v>(interleaved);
+	}
+}
+
+auto LoudnessMeter::measure() const -> Loudness {
+	return Loudness{.integrated = integrate(m_blocks), .true_peak = m_true_peak};
+}
+
+auto LoudnessMeter::integrate(std::span<float const> const block_energies) -> float {
+	static auto const absolute_gate_v = from_lufs(Loudness::silence_v);
+	auto gated = 0.0;
+	auto count = std::size_t{};
+	for (auto const energy : block_energies) {
+		if (energy <= absolute_gate_v) { continue; }
+		gated += energy;
+		++count;
+	}
+	if (count == 0) { return Loudness::silence_v; }
+
+	auto const relative_gate = (gated / double(count)) * relative_gate_v;
+	gated = 0.0;
+	count = 0;
+	for (auto const energy : block_energies) {
+		if (energy <= absolute_gate_v || energy <= relative_gate) { continue; }
+		gated += energy;
+		++count;
+	}
+	if (count == 0) { return Loudness::silence_v; }
+	return std::max(to_lufs(gated / double(count)), Loudness::silence_v);
+}
+
+auto LoudnessMeter::to_histogram(std::span<float const> const block_energies) -> std::vector<std::uint32_t> {
+	auto ret = std::vector<std::uint32_t>{};
+	for (auto const energy : block_energies) {
+		auto const lufs = to_lufs(energy);
+		if (!(lufs > Loudness::silence_v)) { continue; }
+		auto const bin = std::min(std::size_t((lufs - Loudness::silence_v) / histogram_step_v), histogram_bins_v - 1);
+		if (bin >= ret.size()) { ret.resize(bin + 1); }
+		++ret[bin];
+	}
+	return ret;
+}
+
+// same gating as integrate(), with every block of a bin taken at the bin's centre
+auto LoudnessMeter::integrate_histogram(std::span<std::uint32_t const> const histogram) -> float {
+	auto const energy = [](std::size_t const bin) {
+		return from_lufs(Loudness::silence_v + ((double(bin) + 0.5) * histogram_step_v));
+	};
+	auto gated = 0.0;
+	auto count = std::uint64_t{};
+	for (std::size_t bin = 0; bin < histogram.size(); ++bin) {
+		gated += double(histogram[bin]) * energy(bin);
+		count += histogram[bin];
+	}
+	if (count == 0) { return Loudness::silence_v; }
+
+	auto const relative_gate = (gated / double(count)) * relative_gate_v;
+	gated = 0.0;
+	count = 0;
+	for (std::size_t bin = 0; bin < histogram.size(); ++bin) {
+		if (energy(bin) <= relative_gate) { continue; }
+		gated += double(histogram[bin]) * energy(bin);
+		count += histogram[bin];
+	}
+	if (count == 0) { return Loudness::silence_v; }
+	return std::max(to_lufs(gated / double(count)), Loudness::silence_v);
+}
+
+template <std::size_t Lanes>
+void LoudnessMeter::process_lanes(std::span<float const> const interleaved) {
+	static_assert(Lanes <= max_channels_v);
+	auto const frames = interleaved.size() / m_stride;
+	auto x = std::array<float, Lanes>{};
+	auto y = std::array<float, Lanes>{};
+	auto& [s1, s2, h1, h2] = m_state;
+	for (std::size_t f = 0; f < frames; ++f) {
+		auto const frame = interleaved.subspan(f * m_stride, m_channels);
+		std::ranges::copy(frame, x.begin());
+
+		auto peak = 0.0f;
+		if (m_oversample) {
+			std::ranges::copy_backward(m_history.begin(), m_history.end() - 1, m_history.end());
+			std::ranges::copy(x, m_history.front().begin());
+			for (auto const& taps : true_peak_taps_v) {
+				auto acc = std::array<float, Lanes>{};
+				for (std::size_t t = 0; t < taps.size(); ++t) {
+					for (std::size_t l = 0; l < Lanes; ++l) { acc[l] += taps[t] * m_history[t][l]; }
+				}
+				for (auto const s : acc) { peak = std::max(peak, std::abs(s)); }
+			}
+		} else {
+			for (auto const s : x) { peak = std::max(peak, std::abs(s)); }
+		}
+		m_true_peak = std::max(m_true_peak, peak);
+
+		for (std::size_t l = 0; l < Lanes; ++l) {
+			y[l] = (m_shelf.b[0] * x[l]) + s1[l];
+			s1[l] = (m_shelf.b[1] * x[l]) - (m_shelf.a[0] * y[l]) + s2[l];
+			s2[l] = (m_shelf.b[2] * x[l]) - (m_shelf.a[1] * y[l]);
+		}
+		for (std::size_t l = 0; l < Lanes; ++l) {
+			auto const in = y[l];
+			y[l] = (m_highpass.b[0] * in) + h1[l];
+			h1[l] = (m_highpass.b[1] * in) - (m_highpass.a[0] * y[l]) + h2[l];
+			h2[l] = (m_highpass.b[2] * in) - (m_highpass.a[1] * y[l]);
+		}
+
+		auto energy = 0.0f;
+		for (std::size_t l = 0; l < Lanes; ++l) { energy += m_weights[l] * y[l] * y[l]; }
+		m_step_energy += energy;
+		if (++m_step_count == m_step_frames) { push_step(float(m_step_energy / double(m_step_frames))); }
+	}
+}
+
+void LoudnessMeter::push_step(float const energy) {
+	m_step_energy = 0.0;
+	m_step_count = 0;
+	m_steps.at(m_steps_filled % block_steps_v) = energy;
+	if (++m_steps_filled < block_steps_v) { return; }
+	auto const sum = std::accumulate(m_steps.begin(), m_steps.end(), 0.0);
+	m_blocks.push_back(float(sum / double(block_steps_v)));
+}
+} // namespace riff
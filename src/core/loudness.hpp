@@ -0,0 +1,76 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace riff {
+// EBU R128 / ITU-R BS.1770 measurement, with ReplayGain 2.0 reference level.
+struct Loudness {
+	static constexpr auto reference_v{-18.0f};
+	static constexpr auto silence_v{-70.0f};
+
+	float integrated{silence_v}; // LUFS
+	float true_peak{};			 // linear
+
+	[[nodiscard]] auto to_gain_db() const -> float;
+};
+
+struct ReplayGain {
+	float track_db{};
+	float album_db{};
+};
+
+class LoudnessMeter {
+  public:
+	static constexpr std::size_t max_channels_v{8};
+
+	explicit LoudnessMeter(std::uint32_t sample_rate, std::uint8_t channels);
+
+	void process(std::span<float const> interleaved);
+
+	[[nodiscard]] auto get_blocks() const -> std::span<float const> { return m_blocks; }
+	[[nodiscard]] auto get_true_peak() const -> float { return m_true_peak; }
+	[[nodiscard]] auto measure() const -> Loudness;
+
+	[[nodiscard]] static auto integrate(std::span<float const> block_energies) -> float;
+
+	// block counts in histogram_step_v LU bins above the absolute gate (as in libebur128's histogram mode):
+	// compact enough to persist, and albums are integrated from the sum of their tracks' histograms.
+	static constexpr auto histogram_step_v{0.1f};
+	[[nodiscard]] static auto to_histogram(std::span<float const> block_energies) -> std::vector<std::uint32_t>;
+	[[nodiscard]] static auto integrate_histogram(std::span<std::uint32_t const> histogram) -> float;
+
+  private:
+	struct Biquad {
+		std::array<float, 3> b{};
+		std::array<float, 2> a{};
+	};
+
+	template <std::size_t Lanes>
+	void process_lanes(std::span<float const> interleaved);
+
+	void push_step(float energy);
+
+	Biquad m_shelf{};
+	Biquad m_highpass{};
+	std::array<float, max_channels_v> m_weights{};
+	// interleave stride: only the first m_channels (at most max_channels_v) are measured
+	std::uint8_t m_stride{};
+	std::uint8_t m_channels{};
+	std::size_t m_step_frames{};
+	bool m_oversample{};
+
+	// per lane filter state, kept in lane-major order so every per-frame op runs across all channels at once
+	std::array<std::array<float, max_channels_v>, 4> m_state{};
+	std::array<std::array<float, max_channels_v>, 12> m_history{};
+
+	double m_step_energy{};
+	std::size_t m_step_count{};
+	std::array<double, 4> m_steps{};
+	std::size_t m_steps_filled{};
+
+	std::vector<float> m_blocks{};
+	float m_true_peak{};
+};
+} // namespace riff
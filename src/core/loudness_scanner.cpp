@@ -0,0 +1,220 @@
+#include <binary_io.hpp>
+#include <capo/buffer.hpp>
+#include <log.hpp>
+#include <loudness_scanner.hpp>
+#include <media_probe.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <optional>
+
+namespace riff {
+namespace {
+constexpr auto magic_v = std::string_view{"riff-loudness"};
+constexpr std::uint32_t version_v{1};
+
+[[nodiscard]] auto scan(std::string const& path) -> std::optional<LoudnessMeter> {
+	auto const info = probe_media(path);
+	if (!info) { return {}; }
+	if (get_decoded_bytes(*info) > max_decoded_bytes_v) {
+		log.info("loudness: track too long to decode for a scan: {}", path);
+		return {};
+	}
+	auto buffer = capo::Buffer{};
+	if (!buffer.decode_file(path.c_str()) || buffer.get_channels() == 0) { return {}; }
+	auto ret = LoudnessMeter{buffer.get_sample_rate(), buffer.get_channels()};
+	ret.process(buffer.get_samples());
+	return ret;
+}
+
+[[nodiscard]] auto get_directory(std::string_view const path) -> std::string_view {
+	auto const slash = path.find_last_of('/');
+	return slash == std::string_view::npos ? std::string_view{} : path.substr(0, slash);
+}
+} // namespace
+
+LoudnessScanner::LoudnessScanner() {
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+// entry: path, size, mtime, failed, [integrated, true peak, bin count, (bin, count) per non-empty bin]
+auto LoudnessScanner::load() -> bool {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return false; }
+	auto const text = std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	auto reader = BinaryReader{std::string_view{text}.substr(std::min(magic_v.size(), text.size()))};
+	auto version = std::uint32_t{};
+	auto count = std::uint64_t{};
+	if (!text.starts_with(magic_v) || !reader.read(version) || version != version_v || !reader.read(count)) {
+		log.warn("ignoring invalid loudness cache: {}", path);
+		return false;
+	}
+
+	auto entries = std::vector<std::pair<std::string, Entry>>{};
+	entries.reserve(std::size_t(std::min<std::uint64_t>(count, text.size())));
+	for (std::uint64_t i = 0; reader.is_ok() && i < count; ++i) {
+		auto& [file_path, entry] = entries.emplace_back();
+		auto failed = std::uint8_t{};
+		auto bins = std::uint32_t{};
+		reader.read(file_path);
+		reader.read(entry.stamp.size);
+		reader.read(entry.stamp.mtime);
+		reader.read(failed);
+		entry.failed = failed != 0;
+		if (entry.failed) { continue; }
+		reader.read(entry.loudness.integrated);
+		reader.read(entry.loudness.true_peak);
+		reader.read(bins);
+		for (std::uint32_t j = 0; reader.is_ok() && j < bins; ++j) {
+			auto bin = std::uint16_t{};
+			auto blocks = std::uint32_t{};
+			reader.read(bin);
+			reader.read(blocks);
+			if (bin >= entry.histogram.size()) { entry.histogram.resize(std::size_t(bin) + 1); }
+			entry.histogram[bin] = blocks;
+		}
+	}
+	if (!reader.is_ok()) {
+		log.warn("ignoring invalid loudness cache: {}", path);
+		return false;
+	}
+
+	auto lock = std::scoped_lock{m_mutex};
+	for (auto& [file_path, entry] : entries) { m_entries.try_emplace(std::move(file_path), std::move(entry)); }
+	log.info("loaded {} loudness measurements from: {}", entries.size(), path);
+	return true;
+}
+
+void LoudnessScanner::enqueue(std::string_view const path) {
+	auto lock = std::scoped_lock{m_mutex};
+	auto& album = get_album(get_directory(path));
+	if (auto const it = m_entries.find(path); it != m_entries.end() && m_measured.contains(path)) {
+		// already measured: republish once the album gain is known
+		if (album.pending > 0) { return; }
+		if (!album.gain_db) {
+			complete(get_directory(path));
+			return;
+		}
+		m_results.push_back(Result{
+			.directory = std::string{get_directory(path)},
+			.album_db = *album.gain_db,
+			.tracks = {TrackGain{.path = std::string{path}, .track_db = it->second.loudness.to_gain_db()}},
+		});
+		return;
+	}
+	if (!m_pending.emplace(path).second) { return; }
+	++album.pending;
+	m_queue.emplace_back(path);
+	m_cv.notify_one();
+}
+
+void LoudnessScanner::invalidate(std::string_view const path) {
+	auto lock = std::scoped_lock{m_mutex};
+	auto const it = m_measured.find(path);
+	if (it == m_measured.end()) { return; }
+	m_measured.erase(it);
+	if (auto const album = m_albums.find(get_directory(path)); album != m_albums.end()) {
+		std::erase(album->second.paths, path);
+		album->second.gain_db.reset();
+	}
+}
+
+void LoudnessScanner::drain_to(std::vector<Result>& out) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_results.empty()) { return; }
+	std::ranges::move(m_results, std::back_inserter(out));
+	m_results.clear();
+}
+
+void LoudnessScanner::run(std::stop_token const& stop) {
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		// saved once per batch of scans, not per file
+		if (m_queue.empty() && m_unsaved) { save(); }
+		if (!m_cv.wait(lock, stop, [this] { return !m_queue.empty(); })) { break; }
+		auto path = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+
+		auto const stamp = FailureCache::get_stamp(path);
+		lock.lock();
+		auto it = m_entries.find(path);
+		if (it == m_entries.end() || it->second.stamp != stamp) {
+			lock.unlock();
+			auto entry = Entry{.stamp = stamp};
+			if (auto const meter = scan(path)) {
+				entry.loudness = meter->measure();
+				entry.histogram = LoudnessMeter::to_histogram(meter->get_blocks());
+				log.debug("{:.1f} LUFS, {:.2f} peak: {}", entry.loudness.integrated, entry.loudness.true_peak, path);
+			} else {
+				entry.failed = true;
+				log.warn("loudness scan failed: {}", path);
+			}
+			lock.lock();
+			it = m_entries.insert_or_assign(path, std::move(entry)).first;
+			m_unsaved = true;
+		}
+
+		auto const directory = std::string{get_directory(path)};
+		m_pending.erase(path);
+		auto& album = get_album(directory);
+		if (!it->second.failed) {
+			album.paths.push_back(path);
+			m_measured.insert(std::move(path));
+		}
+		if (--album.pending == 0) { complete(directory); }
+	}
+
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_unsaved) { save(); }
+}
+
+auto LoudnessScanner::get_album(std::string_view const directory) -> Album& {
+	if (auto const it = m_albums.find(directory); it != m_albums.end()) { return it->second; }
+	return m_albums.emplace(std::string{directory}, Album{}).first->second;
+}
+
+// runs once per batch of scans in a directory: O(tracks in the album)
+void LoudnessScanner::complete(std::string_view const directory) {
+	auto& album = get_album(directory);
+	auto histogram = std::vector<std::uint32_t>{};
+	auto loudness = Loudness{};
+	auto result = Result{.directory = std::string{directory}};
+	result.tracks.reserve(album.paths.size());
+	for (auto const& path : album.paths) {
+		auto const& entry = m_entries.at(path);
+		if (histogram.size() < entry.histogram.size()) { histogram.resize(entry.histogram.size()); }
+		for (std::size_t i = 0; i < entry.histogram.size(); ++i) { histogram[i] += entry.histogram[i]; }
+		loudness.true_peak = std::max(loudness.true_peak, entry.loudness.true_peak);
+		result.tracks.push_back(TrackGain{.path = path, .track_db = entry.loudness.to_gain_db()});
+	}
+	loudness.integrated = LoudnessMeter::integrate_histogram(histogram);
+	album.gain_db = result.album_db = loudness.to_gain_db();
+	if (!result.tracks.empty()) { m_results.push_back(std::move(result)); }
+}
+
+void LoudnessScanner::save() {
+	auto text = std::string{magic_v};
+	auto writer = BinaryWriter{text};
+	writer.write(version_v);
+	writer.write(std::uint64_t(m_entries.size()));
+	for (auto const& [file_path, entry] : m_entries) {
+		writer.write(file_path);
+		writer.write(entry.stamp.size);
+		writer.write(entry.stamp.mtime);
+		writer.write(std::uint8_t(entry.failed));
+		if (entry.failed) { continue; }
+		writer.write(entry.loudness.integrated);
+		writer.write(entry.loudness.true_peak);
+		auto const bins = std::ranges::count_if(entry.histogram, [](std::uint32_t const c) { return c > 0; });
+		writer.write(std::uint32_t(bins));
+		for (std::size_t bin = 0; bin < entry.histogram.size(); ++bin) {
+			if (entry.histogram[bin] == 0) { continue; }
+			writer.write(std::uint16_t(bin));
+			writer.write(entry.histogram[bin]);
+		}
+	}
+	m_writer.submit(path, std::move(text));
+	m_unsaved = false;
+}
+} // namespace riff
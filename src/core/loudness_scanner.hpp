@@ -0,0 +1,84 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <failure_cache.hpp>
+#include <file_writer.hpp>
+#include <loudness.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace riff {
+// Measures files on a worker thread. Results are published per album (directory), once none of its files are pending:
+// album gain is measured over the gated block histograms of every scanned track in the directory.
+// Measurements and failures are saved to path, stamped with the size and mtime of the file:
+// unchanged files are never decoded again, not even across runs.
+class LoudnessScanner : public klib::Pinned {
+  public:
+	struct TrackGain {
+		std::string path{};
+		float track_db{};
+	};
+
+	struct Result {
+		std::string directory{};
+		float album_db{};
+		std::vector<TrackGain> tracks{};
+	};
+
+	LoudnessScanner();
+
+	// entries already measured in this run are kept
+	auto load() -> bool;
+
+	void enqueue(std::string_view path);
+	// drops the cached measurement of a file that changed on disk
+	void invalidate(std::string_view path);
+	void drain_to(std::vector<Result>& out);
+
+	std::string path{"riff.loudness"};
+
+  private:
+	struct Entry {
+		FailureCache::Stamp stamp{};
+		Loudness loudness{};
+		std::vector<std::uint32_t> histogram{};
+		bool failed{};
+	};
+
+	struct Album {
+		std::vector<std::string> paths{};
+		std::size_t pending{};
+		std::optional<float> gain_db{};
+	};
+
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	void run(std::stop_token const& stop);
+	[[nodiscard]] auto get_album(std::string_view directory) -> Album&;
+	void complete(std::string_view directory);
+	void save();
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::deque<std::string> m_queue{};
+	std::unordered_set<std::string, Hash, std::equal_to<>> m_pending{};
+	// every entry saved / loaded, and those whose stamp has been verified in this run
+	std::unordered_map<std::string, Entry, Hash, std::equal_to<>> m_entries{};
+	std::unordered_set<std::string, Hash, std::equal_to<>> m_measured{};
+	std::unordered_map<std::string, Album, Hash, std::equal_to<>> m_albums{};
+	std::vector<Result> m_results{};
+	bool m_unsaved{};
+
+	FileWriter m_writer{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
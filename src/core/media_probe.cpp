@@ -0,0 +1,227 @@
+#include <media_probe.hpp>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+constexpr std::size_t head_size_v{64 * 1024};
+
+class Reader {
+  public:
+	explicit Reader(std::span<std::byte const> bytes) : m_bytes(bytes) {}
+
+	[[nodiscard]] auto remaining() const -> std::size_t { return m_bytes.size() - m_offset; }
+	[[nodiscard]] auto offset() const -> std::size_t { return m_offset; }
+
+	[[nodiscard]] auto matches(std::string_view const magic, std::size_t const at = 0) const -> bool {
+		if (m_offset + at + magic.size() > m_bytes.size()) { return false; }
+		for (std::size_t i = 0; i < magic.size(); ++i) {
+			if (m_bytes[m_offset + at + i] != std::byte(magic[i])) { return false; }
+		}
+		return true;
+	}
+
+	[[nodiscard]] auto u8(std::size_t const at) const -> std::uint32_t {
+		if (m_offset + at >= m_bytes.size()) { return 0; }
+		return std::uint32_t(m_bytes[m_offset + at]);
+	}
+
+	[[nodiscard]] auto le(std::size_t const at, std::size_t const count) const -> std::uint64_t {
+		auto ret = std::uint64_t{};
+		for (std::size_t i = 0; i < count; ++i) { ret |= std::uint64_t(u8(at + i)) << (8 * i); }
+		return ret;
+	}
+
+	[[nodiscard]] auto be(std::size_t const at, std::size_t const count) const -> std::uint64_t {
+		auto ret = std::uint64_t{};
+		for (std::size_t i = 0; i < count; ++i) { ret = (ret << 8) | u8(at + i); }
+		return ret;
+	}
+
+	auto skip(std::size_t const count) -> bool {
+		if (count > remaining()) {
+			m_offset = m_bytes.size();
+			return false;
+		}
+		m_offset += count;
+		return true;
+	}
+
+  private:
+	std::span<std::byte const> m_bytes;
+	std::size_t m_offset{};
+};
+
+void skip_id3v2(Reader& reader) {
+	if (!reader.matches("ID3") || reader.remaining() < 10) { return; }
+	auto size = std::size_t{};
+	for (std::size_t i = 6; i < 10; ++i) { size = (size << 7) | (reader.u8(i) & 0x7f); }
+	auto const has_footer = (reader.u8(5) & 0x10) != 0;
+	reader.skip(10 + size + (has_footer ? 10 : 0));
+}
+
+auto probe_wav(Reader reader, std::uint64_t const file_size) -> std::optional<MediaInfo> {
+	if (!reader.matches("RIFF") || !reader.matches("WAVE", 8)) { return {}; }
+	reader.skip(12);
+	auto ret = MediaInfo{.format = AudioFormat::Wav};
+	auto byte_rate = std::uint64_t{};
+	while (reader.remaining() >= 8) {
+		auto const size = reader.le(4, 4);
+		if (reader.matches("fmt ")) {
+			ret.channels = std::uint8_t(reader.le(10, 2));
+			ret.sample_rate = std::uint32_t(reader.le(12, 4));
+			byte_rate = reader.le(16, 4);
+		} else if (reader.matches("data")) {
+			if (byte_rate == 0) { return {}; }
+			auto const available = file_size - std::min<std::uint64_t>(file_size, reader.offset() + 8);
+			ret.duration = Time{double(std::min(size, available)) / double(byte_rate)};
+			return ret;
+		}
+		if (!reader.skip(8 + size + (size & 1))) { break; }
+	}
+	return {};
+}
+
+auto probe_flac(Reader reader) -> std::optional<MediaInfo> {
+	skip_id3v2(reader);
+	if (!reader.matches("fLaC") || (reader.u8(4) & 0x7f) != 0) { return {}; }
+	reader.skip(8); // magic, STREAMINFO block header
+	if (reader.remaining() < 34) { return {}; }
+	auto const packed = reader.be(10, 8);
+	auto ret = MediaInfo{.format = AudioFormat::Flac};
+	ret.sample_rate = std::uint32_t(packed >> 44);
+	ret.channels = std::uint8_t(((packed >> 41) & 0x7) + 1);
+	auto const total_samples = packed & 0xf'ffff'ffff;
+	if (ret.sample_rate == 0) { return {}; }
+	ret.duration = Time{double(total_samples) / double(ret.sample_rate)};
+	return ret;
+}
+
+struct Mp3Frame {
+	std::uint32_t bitrate{};
+	std::uint32_t sample_rate{};
+	std::uint32_t samples{};
+	std::uint32_t length{};
+	std::uint8_t channels{};
+	bool mpeg1{};
+};
+
+auto parse_mp3_frame(std::uint32_t const header) -> std::optional<Mp3Frame> {
+	static constexpr auto bitrates_v = std::array{
+		std::array<std::uint16_t, 16>{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+		std::array<std::uint16_t, 16>{0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+		std::array<std::uint16_t, 16>{0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},
+		std::array<std::uint16_t, 16>{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+		std::array<std::uint16_t, 16>{0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+	};
+	static constexpr auto sample_rates_v = std::array<std::uint32_t, 3>{44100, 48000, 32000};
+
+	if ((header >> 21) != 0x7ff) { return {}; }
+	auto const version = (header >> 19) & 0x3; // 0: 2.5, 2: 2, 3: 1
+	auto const layer = 4 - ((header >> 17) & 0x3);
+	auto const bitrate_index = (header >> 12) & 0xf;
+	auto const rate_index = (header >> 10) & 0x3;
+	if (version == 1 || layer == 4 || bitrate_index == 0 || bitrate_index == 15 || rate_index == 3) { return {}; }
+
+	auto ret = Mp3Frame{.mpeg1 = version == 3};
+	auto const table = ret.mpeg1 ? layer - 1 : (layer == 1 ? 3 : 4);
+	ret.bitrate = bitrates_v.at(table).at(bitrate_index) * 1000u;
+	ret.sample_rate = sample_rates_v.at(rate_index) >> (version == 3 ? 0 : (version == 2 ? 1 : 2));
+	ret.channels = ((header >> 6) & 0x3) == 3 ? 1 : 2;
+	auto const padding = (header >> 9) & 0x1;
+	if (layer == 1) {
+		ret.samples = 384;
+		ret.length = (12 * ret.bitrate / ret.sample_rate + padding) * 4;
+	} else {
+		ret.samples = layer == 3 && !ret.mpeg1 ? 576 : 1152;
+		ret.length = (ret.samples / 8) * ret.bitrate / ret.sample_rate + padding;
+	}
+	return ret;
+}
+
+auto probe_mp3(Reader reader, std::uint64_t const file_size) -> std::optional<MediaInfo> {
+	skip_id3v2(reader);
+	auto frame = std::optional<Mp3Frame>{};
+	while (reader.remaining() >= 4) {
+		frame = parse_mp3_frame(std::uint32_t(reader.be(0, 4)));
+		// require the following frame to line up as well, when it is within the buffer
+		if (frame && (reader.remaining() < frame->length + 4 ||
+					  parse_mp3_frame(std::uint32_t(reader.be(frame->length, 4))).has_value())) {
+			break;
+		}
+		frame.reset();
+		reader.skip(1);
+	}
+	if (!frame) { return {}; }
+
+	auto ret = MediaInfo{.format = AudioFormat::Mp3, .sample_rate = frame->sample_rate, .channels = frame->channels};
+	auto const side_info = frame->mpeg1 ? (frame->channels == 1 ? 17u : 32u) : (frame->channels == 1 ? 9u : 17u);
+	auto frames = std::uint64_t{};
+	if (reader.matches("Xing", 4 + side_info) || reader.matches("Info", 4 + side_info)) {
+		auto const flags = reader.be(8 + side_info, 4);
+		if ((flags & 0x1) != 0) { frames = reader.be(12 + side_info, 4); }
+	} else if (reader.matches("VBRI", 36)) {
+		frames = reader.be(36 + 14, 4);
+	}
+	if (frames > 0) {
+		ret.duration = Time{double(frames * frame->samples) / double(frame->sample_rate)};
+	} else {
+		auto const audio_bytes = file_size - std::min<std::uint64_t>(file_size, reader.offset());
+		ret.duration = Time{double(audio_bytes) * 8.0 / double(frame->bitrate)};
+	}
+	return ret;
+}
+} // namespace
+
+auto probe_media(std::span<std::byte const> const head, std::uint64_t const file_size) -> std::optional<MediaInfo> {
+	auto const reader = Reader{head};
+	if (auto ret = probe_wav(reader, file_size)) { return ret; }
+	if (auto ret = probe_flac(reader)) { return ret; }
+	return probe_mp3(reader, file_size);
+}
+
+auto sniff_media(std::span<std::byte const> const head) -> AudioFormat {
+	auto reader = Reader{head};
+	if (reader.matches("RIFF") && reader.matches("WAVE", 8)) { return AudioFormat::Wav; }
+	if (reader.matches("ID3")) {
+		// version 2.2 - 2.4, syncsafe size
+		auto const version = reader.u8(3);
+		if (version < 2 || version > 4 || ((reader.u8(6) | reader.u8(7) | reader.u8(8) | reader.u8(9)) & 0x80) != 0) {
+			return AudioFormat::Unknown;
+		}
+		skip_id3v2(reader);
+		// a well-formed tag ending at (or just before) the end of head, or followed directly by a frame header:
+		// the frame after that one may lie past head
+		if (reader.remaining() < 4 || parse_mp3_frame(std::uint32_t(reader.be(0, 4)))) { return AudioFormat::Mp3; }
+	}
+	// STREAMINFO must be the first metadata block
+	if (reader.matches("fLaC")) {
+		auto const is_streaminfo = (reader.u8(4) & 0x7f) == 0 && reader.be(5, 3) == 34;
+		return is_streaminfo ? AudioFormat::Flac : AudioFormat::Unknown;
+	}
+	// two consecutive frames must line up inside head
+	for (; reader.remaining() >= 4; reader.skip(1)) {
+		auto const frame = parse_mp3_frame(std::uint32_t(reader.be(0, 4)));
+		if (!frame || reader.remaining() < frame->length + 4) { continue; }
+		if (parse_mp3_frame(std::uint32_t(reader.be(frame->length, 4)))) { return AudioFormat::Mp3; }
+	}
+	return AudioFormat::Unknown;
+}
+
+auto probe_media(std::string const& path) -> std::optional<MediaInfo> {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (!file) { return {}; }
+	auto head = std::vector<std::byte>(head_size_v);
+	file.read(reinterpret_cast<char*>(head.data()), std::streamsize(head.size())); // NOLINT
+	head.resize(std::size_t(file.gcount()));
+	auto ec = std::error_code{};
+	auto const file_size = fs::file_size(path, ec);
+	if (ec) { return {}; }
+	return probe_media(head, file_size);
+}
+} // namespace riff
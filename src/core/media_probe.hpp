@@ -0,0 +1,34 @@
+#pragma once
+#include <time.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace riff {
+enum class AudioFormat : std::int8_t { Unknown, Wav, Flac, Mp3, COUNT_ };
+
+struct MediaInfo {
+	AudioFormat format{};
+	Time duration{};
+	std::uint32_t sample_rate{};
+	std::uint8_t channels{};
+};
+
+// analysis (pcm tap, loudness scans) decodes whole tracks into memory, capo-lite has no streaming decoder:
+// tracks that would decode to more than this are skipped. about 6 minutes of 44.1kHz stereo.
+inline constexpr std::uint64_t max_decoded_bytes_v{128 * 1024 * 1024};
+
+[[nodiscard]] constexpr auto get_decoded_bytes(MediaInfo const& info) -> std::uint64_t {
+	return std::uint64_t(info.duration.count() * float(info.sample_rate)) * info.channels * sizeof(float);
+}
+
+// reads container headers only, never decodes:
+// WAV fmt/data chunks, FLAC STREAMINFO, MP3 Xing/Info/VBRI or a CBR estimate
+[[nodiscard]] auto probe_media(std::span<std::byte const> head, std::uint64_t file_size) -> std::optional<MediaInfo>;
+[[nodiscard]] auto probe_media(std::string const& path) -> std::optional<MediaInfo>;
+
+// identifies the container from its magic bytes (a few KiB are plenty), stricter than probe_media about MP3 sync.
+// a file starting with an ID3v2 tag that extends past head is taken to be MP3.
+[[nodiscard]] auto sniff_media(std::span<std::byte const> head) -> AudioFormat;
+} // namespace riff
@@ -0,0 +1,6 @@
+#pragma once
+#include <cstdint>
+
+namespace riff {
+enum class Normalize : std::int8_t { Off, Track, Album, COUNT_ };
+} // namespace riff
@@ -0,0 +1,43 @@
+#include <output_latency.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace riff {
+void OutputLatency::on_play(Time const cursor) {
+	m_play_at = Clock::now();
+	m_cursor = cursor;
+}
+
+void OutputLatency::sample(Time const cursor, bool const playing) {
+	auto const was_playing = std::exchange(m_playing, playing);
+	auto const previous = std::exchange(m_cursor, cursor);
+	if (!playing) {
+		m_play_at.reset();
+		return;
+	}
+	if (cursor <= previous) { return; }
+	if (m_play_at) {
+		m_starts.push(std::chrono::duration<float, std::milli>(Clock::now() - *m_play_at).count());
+		m_play_at.reset();
+		return;
+	}
+	// seeks and resumes are not steps
+	static constexpr auto max_step_v = Time{0.5f};
+	if (was_playing && cursor - previous < max_step_v) {
+		m_steps.push(std::chrono::duration<float, std::milli>(cursor - previous).count());
+	}
+}
+
+auto OutputLatency::get_estimate() const -> std::optional<Estimate> {
+	if (m_starts.count == 0) { return {}; }
+	auto starts = m_starts.values;
+	auto const first = starts.begin();
+	auto const last = first + std::ptrdiff_t(m_starts.count);
+	std::nth_element(first, first + std::ptrdiff_t(m_starts.count / 2), last);
+	auto ret = Estimate{.start_ms = *(first + std::ptrdiff_t(m_starts.count / 2))};
+	if (m_steps.count > 0) {
+		ret.step_ms = *std::min_element(m_steps.values.begin(), m_steps.values.begin() + std::ptrdiff_t(m_steps.count));
+	}
+	return ret;
+}
+} // namespace riff
@@ -0,0 +1,47 @@
+#pragma once
+#include <time.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+
+namespace riff {
+// Measures output latency from the outside, since capo does not report its device buffer configuration.
+// start: play() until the cursor first moves, covering device start up and the first period(s) of buffering.
+// step: the smallest cursor advance seen between samples, an upper bound on the device period.
+class OutputLatency {
+  public:
+	static constexpr std::size_t window_v{32};
+
+	// milliseconds, medians / minimums over the last window_v measurements
+	struct Estimate {
+		float start_ms{};
+		float step_ms{};
+	};
+
+	void on_play(Time cursor);
+	void sample(Time cursor, bool playing);
+
+	// empty until a start has been measured
+	[[nodiscard]] auto get_estimate() const -> std::optional<Estimate>;
+
+  private:
+	struct Window {
+		void push(float const value) {
+			values.at(next) = value;
+			next = (next + 1) % window_v;
+			count = std::min(count + 1, window_v);
+		}
+
+		std::array<float, window_v> values{};
+		std::size_t next{};
+		std::size_t count{};
+	};
+
+	Window m_starts{};
+	Window m_steps{};
+	std::optional<Clock::time_point> m_play_at{};
+	Time m_cursor{};
+	bool m_playing{};
+};
+} // namespace riff
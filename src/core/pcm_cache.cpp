@@ -0,0 +1,40 @@
+#include <log.hpp>
+#include <pcm_cache.hpp>
+#include <algorithm>
+
+namespace riff {
+auto PcmCache::get(Track const& track) -> std::shared_ptr<capo::Buffer const> {
+	if (track.size == 0 || track.size > max_file_size_v) { return {}; }
+	if (auto const it = m_entries.find(track.path); it != m_entries.end()) {
+		auto& entry = it->second;
+		if (entry.size == track.size && entry.mtime == track.mtime) {
+			entry.last_used = ++m_uses;
+			return entry.buffer;
+		}
+		m_bytes -= entry.bytes;
+		m_entries.erase(it);
+	}
+
+	auto buffer = std::make_shared<capo::Buffer>();
+	if (!buffer->decode_file(track.path.c_str()) || buffer->get_channels() == 0) {
+		log.warn("failed to decode into memory: {}", track.path);
+		return {};
+	}
+	auto const bytes = std::uint64_t(buffer->get_samples().size_bytes());
+	if (bytes > budget_v) { return buffer; }
+	evict(bytes);
+	m_bytes += bytes;
+	auto entry = Entry{.buffer = buffer, .size = track.size, .mtime = track.mtime, .bytes = bytes, .last_used = ++m_uses};
+	m_entries.insert_or_assign(track.path, std::move(entry));
+	return buffer;
+}
+
+// buffers still bound elsewhere stay alive through their shared owners
+void PcmCache::evict(std::uint64_t const bytes) {
+	while (!m_entries.empty() && m_bytes + bytes > budget_v) {
+		auto const it = std::ranges::min_element(m_entries, {}, [](auto const& kvp) { return kvp.second.last_used; });
+		m_bytes -= it->second.bytes;
+		m_entries.erase(it);
+	}
+}
+} // namespace riff
@@ -0,0 +1,43 @@
+#pragma once
+#include <capo/buffer.hpp>
+#include <klib/base_types.hpp>
+#include <track.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace riff {
+// Fully decoded PCM of small files, shared with the source and the tap while in use.
+// Entries are keyed by path, size and mtime, least recently used buffers are dropped beyond budget_v bytes of samples.
+class PcmCache : public klib::Pinned {
+  public:
+	// files up to this size are decoded into memory instead of being streamed
+	static constexpr std::uint64_t max_file_size_v{1024 * 1024};
+	static constexpr std::uint64_t budget_v{128 * 1024 * 1024};
+
+	PcmCache() = default;
+
+	// null if the track is too large (or its size is unknown) or fails to decode
+	[[nodiscard]] auto get(Track const& track) -> std::shared_ptr<capo::Buffer const>;
+
+  private:
+	struct Entry {
+		std::shared_ptr<capo::Buffer const> buffer{};
+		std::uint64_t size{};
+		std::int64_t mtime{};
+		std::uint64_t bytes{};
+		std::uint64_t last_used{};
+	};
+
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	void evict(std::uint64_t bytes);
+
+	std::unordered_map<std::string, Entry, Hash, std::equal_to<>> m_entries{};
+	std::uint64_t m_bytes{};
+	std::uint64_t m_uses{};
+};
+} // namespace riff
@@ -0,0 +1,111 @@
+#include <log.hpp>
+#include <media_probe.hpp>
+#include <pcm_tap.hpp>
+#include <algorithm>
+#include <utility>
+
+namespace riff {
+PcmTap::PcmTap(std::vector<ISink*> sinks) : m_sinks(std::move(sinks)) {}
+
+void PcmTap::attach(std::string_view const path, std::shared_ptr<capo::Buffer const> buffer) {
+	auto lock = std::scoped_lock{m_mutex};
+	m_path = path;
+	m_path_buffer = std::move(buffer);
+	m_path_changed = true;
+	m_cv.notify_one();
+}
+
+// the worker is started on first enable: players without a UI never spawn it (or decode anything)
+void PcmTap::set_enabled(bool const enabled) {
+	if (enabled && !m_thread.joinable()) {
+		m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+	}
+	auto lock = std::scoped_lock{m_mutex};
+	if (enabled == m_enabled) { return; }
+	m_enabled = enabled;
+	m_cv.notify_one();
+}
+
+void PcmTap::update(Time const cursor, bool const playing) {
+	m_cursor.store(cursor.count(), std::memory_order_relaxed);
+	m_cursor_at.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+	m_playing.store(playing, std::memory_order_release);
+}
+
+// extrapolate from the last cursor published by the UI thread, so the hop is independent of the frame rate
+auto PcmTap::get_cursor() const -> Time {
+	auto const playing = m_playing.load(std::memory_order_acquire);
+	auto const cursor = Time{m_cursor.load(std::memory_order_relaxed)};
+	if (!playing) { return cursor; }
+	auto const cursor_at = Clock::time_point{Clock::duration{m_cursor_at.load(std::memory_order_relaxed)}};
+	return cursor + std::chrono::duration_cast<Time>(Clock::now() - cursor_at);
+}
+
+void PcmTap::run(std::stop_token const& stop) {
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (!m_cv.wait(lock, stop, [this] { return m_enabled && (m_path_changed || m_buffer); })) { return; }
+		if (m_path_changed) {
+			m_path_changed = false;
+			auto path = m_path;
+			auto buffer = m_path_buffer;
+			lock.unlock();
+			load(std::move(path), std::move(buffer));
+			continue;
+		}
+		lock.unlock();
+
+		auto const rate = m_buffer->get_sample_rate();
+		auto const frames = m_buffer->get_samples().size() / m_buffer->get_channels();
+		auto const target = std::min(std::size_t(std::max(get_cursor().count(), 0.0f) * float(rate)), frames);
+		if (target > m_frame) {
+			auto const max_frames = std::size_t(std::chrono::duration_cast<Time>(max_window_v).count() * float(rate));
+			write(std::max(m_frame, target - std::min(target, max_frames)), target);
+		} else {
+			for (auto* sink : m_sinks) { sink->reset(); }
+		}
+		m_frame = target;
+
+		lock.lock();
+		m_cv.wait_for(lock, stop, hop_v, [this] { return !m_enabled || m_path_changed; });
+	}
+}
+
+void PcmTap::load(std::string path, std::shared_ptr<capo::Buffer const> buffer) {
+	m_buffer.reset();
+	m_frame = 0;
+	for (auto* sink : m_sinks) { sink->reset(); }
+	if (path.empty()) { return; }
+	if (buffer) {
+		m_buffer = std::move(buffer);
+		return;
+	}
+
+	auto const info = probe_media(path);
+	if (!info) { return; }
+	if (get_decoded_bytes(*info) > max_decoded_bytes_v) {
+		log.info("pcm tap: track too long to decode for analysis: {}", path);
+		return;
+	}
+
+	auto decoded = std::make_shared<capo::Buffer>();
+	if (!decoded->decode_file(path.c_str()) || decoded->get_channels() == 0) {
+		log.warn("pcm tap: failed to decode: {}", path);
+		return;
+	}
+	m_buffer = std::move(decoded);
+}
+
+void PcmTap::write(std::size_t const first, std::size_t const last) {
+	auto const channels = m_buffer->get_channels();
+	auto const sample_rate = m_buffer->get_sample_rate();
+	auto samples = m_buffer->get_samples().subspan(first * channels, (last - first) * channels);
+	auto const gain = m_gain.load(std::memory_order_relaxed);
+	if (gain != 1.0f) {
+		m_scratch.assign(samples.begin(), samples.end());
+		for (auto& sample : m_scratch) { sample *= gain; }
+		samples = m_scratch;
+	}
+	for (auto* sink : m_sinks) { sink->write(samples, channels, sample_rate); }
+}
+} // namespace riff
@@ -0,0 +1,69 @@
+#pragma once
+#include <capo/buffer.hpp>
+#include <klib/base_types.hpp>
+#include <time.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace riff {
+// Follows the playback cursor of the active track and feeds the samples around it to analysis sinks.
+// capo-lite does not expose its mixer output, so the tap decodes its own copy of the track, and only while enabled.
+// Tracks that would decode to more than max_decoded_bytes_v are not tapped (unless already decoded for playback).
+class PcmTap : public klib::Pinned {
+  public:
+	struct ISink : klib::Polymorphic {
+		virtual void write(std::span<float const> interleaved, std::uint8_t channels, std::uint32_t sample_rate) = 0;
+		virtual void reset() = 0;
+	};
+
+	static constexpr auto hop_v{10ms};
+	static constexpr auto max_window_v{100ms};
+
+	explicit PcmTap(std::vector<ISink*> sinks);
+
+	// buffer (optional) holds the decoded track already, sparing the tap its own decode
+	void attach(std::string_view path, std::shared_ptr<capo::Buffer const> buffer = {});
+	void detach() { attach({}); }
+
+	void set_enabled(bool enabled);
+	[[nodiscard]] auto is_enabled() const -> bool { return m_enabled; }
+
+	// linear output gain (volume and replay gain), applied to samples before they reach the sinks
+	void set_gain(float const gain) { m_gain.store(gain, std::memory_order_relaxed); }
+
+	void update(Time cursor, bool playing);
+
+  private:
+	[[nodiscard]] auto get_cursor() const -> Time;
+
+	void run(std::stop_token const& stop);
+	void load(std::string path, std::shared_ptr<capo::Buffer const> buffer);
+	void write(std::size_t first, std::size_t last);
+
+	std::vector<ISink*> m_sinks{};
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::string m_path{};
+	std::shared_ptr<capo::Buffer const> m_path_buffer{};
+	bool m_path_changed{};
+	bool m_enabled{};
+
+	std::atomic<float> m_cursor{};
+	std::atomic<Clock::rep> m_cursor_at{};
+	std::atomic<bool> m_playing{};
+	std::atomic<float> m_gain{1.0f};
+
+	std::shared_ptr<capo::Buffer const> m_buffer{};
+	std::size_t m_frame{};
+	std::vector<float> m_scratch{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
@@ -0,0 +1,111 @@
+#include <log.hpp>
+#include <playback.hpp>
+#include <profiler.hpp>
+#include <filesystem>
+#include <fstream>
+
+namespace riff {
+namespace {
+// a file that is missing or unreadable (unmounted, permissions) failed for transient reasons, not its contents
+[[nodiscard]] auto is_readable(std::string const& path) -> bool {
+	auto ec = std::error_code{};
+	if (!std::filesystem::is_regular_file(path, ec)) { return false; }
+	return std::ifstream{path, std::ios::binary}.is_open();
+}
+} // namespace
+
+auto Playback::play_track(Track& track) -> bool {
+	if (!load_track(track)) { return false; }
+	if (!m_player->is_playing()) {
+		m_player->play();
+		m_playing = m_player->is_playing();
+	}
+	return true;
+}
+
+void Playback::unload_active() {
+	m_player->unload_track();
+	m_playing = false;
+}
+
+void Playback::skip_prev() {
+	auto const is_playing = m_player->is_playing();
+	if (is_playing && m_player->get_cursor() > 3s) {
+		m_player->set_cursor(0s);
+		return;
+	}
+	if (!cycle([this] { return m_tracklist->cycle_prev(); })) { return; }
+	if (is_playing && !m_player->is_playing()) { m_player->play(); }
+}
+
+void Playback::skip_next() {
+	auto const is_playing = m_player->is_playing();
+	cycle([this] { return m_tracklist->cycle_next(); });
+	if (is_playing && !m_player->is_playing()) { m_player->play(); }
+}
+
+void Playback::advance() {
+	auto const pred = [this] {
+		return (m_player->get_repeat() == Repeat::All || m_tracklist->has_next_track()) &&
+			   m_tracklist->has_playable_track();
+	};
+	if (!cycle(pred, [this] { return m_tracklist->cycle_next(); })) { return; }
+	m_player->play();
+	m_playing = m_player->is_playing();
+}
+
+void Playback::update() {
+	if (m_playing && m_player->at_end()) { advance(); }
+	m_playing = m_player->is_playing();
+	m_player->sample_latency();
+	prefetch_next();
+
+	// capo does not expose the device callback: the first frame the cursor has moved stands in for the first buffer
+	if constexpr (Profiler::enabled_v) {
+		if (!m_playing) {
+			Profiler::self().cancel_load();
+		} else if (m_player->get_cursor() > 0s) {
+			Profiler::self().mark_load(Profiler::LoadStage::FirstAudio);
+		}
+	}
+}
+
+template <typename F>
+auto Playback::cycle(F get_track) -> bool {
+	return cycle([this] { return m_tracklist->has_playable_track(); }, get_track);
+}
+
+// tracks already known to fail are passed over without being opened: they are retried once their status is reset
+template <typename Pred, typename F>
+auto Playback::cycle(Pred pred, F get_track) -> bool {
+	while (pred()) {
+		auto* track = get_track();
+		if (track == nullptr) { return false; }
+		if (track->status == Track::Status::Error) { continue; }
+		if (load_track(*track)) { return true; }
+	}
+	return false;
+}
+
+// warms the page cache for the track that advance() or skip_next() will open, once per active track
+void Playback::prefetch_next() {
+	auto const* active = m_tracklist->get_active();
+	if (active == m_prefetched_for) { return; }
+	m_prefetched_for = active;
+	if (active == nullptr || m_player->get_repeat() == Repeat::One) { return; }
+	if (m_player->get_repeat() != Repeat::All && !m_tracklist->has_next_track()) { return; }
+	if (auto const* next = m_tracklist->peek_next()) { m_readahead.prefetch(next->path); }
+}
+
+auto Playback::load_track(Track& track) -> bool {
+	if (m_player->load_track(track)) {
+		if (m_failures != nullptr) { m_failures->erase(track.path); }
+		return true;
+	}
+	log.error("failed to load track: {}", track.path);
+	if (m_failures != nullptr && is_readable(track.path)) {
+		m_failures->insert(track.path, FailureCache::get_stamp(track.path));
+	}
+	return false;
+}
+} // namespace riff
@@ -0,0 +1,45 @@
+#pragma once
+#include <failure_cache.hpp>
+#include <player.hpp>
+#include <readahead.hpp>
+#include <tracklist.hpp>
+
+namespace riff {
+class Playback {
+  public:
+	// failures (optional) records tracks that fail to load, and forgets them once they load again
+	explicit Playback(Player& player, Tracklist& tracklist, FailureCache* failures = nullptr)
+		: m_player(&player), m_tracklist(&tracklist), m_failures(failures) {}
+
+	[[nodiscard]] auto is_playing() const -> bool { return m_playing; }
+
+	auto play_track(Track& track) -> bool;
+	void unload_active();
+
+	void skip_prev();
+	void skip_next();
+	void advance();
+
+	void update();
+	// one frame of the main window: update(), then the player above the tracklist (defined in the UI library)
+	void update_frame(Player::IMediator& player_mediator, Tracklist::IMediator& tracklist_mediator);
+
+  private:
+	template <typename F>
+	auto cycle(F get_track) -> bool;
+	template <typename Pred, typename F>
+	auto cycle(Pred pred, F get_track) -> bool;
+
+	auto load_track(Track& track) -> bool;
+	void prefetch_next();
+
+	Player* m_player;
+	Tracklist* m_tracklist;
+	FailureCache* m_failures;
+	bool m_playing{};
+
+	Readahead m_readahead{};
+	// active track when the next one was last prefetched
+	Track const* m_prefetched_for{};
+};
+} // namespace riff
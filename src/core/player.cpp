@@ -0,0 +1,107 @@
+#include <capo/format.hpp>
+#include <player.hpp>
+#include <profiler.hpp>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace riff {
+namespace {
+auto const duration_0_str = capo::format_duration(0s);
+} // namespace
+
+Player::Player(std::unique_ptr<capo::ISource> source) : m_source(std::move(source)) {
+	assert(m_source);
+	m_cursor_str = duration_0_str;
+	m_duration_str = duration_0_str.c_str();
+}
+
+void Player::set_repeat(Repeat const repeat) {
+	m_repeat = repeat;
+	m_source->set_looping(m_repeat == Repeat::One);
+}
+
+void Player::set_volume(int const volume) {
+	m_volume = volume;
+	update_gain();
+}
+
+void Player::set_normalize(Normalize const normalize) {
+	m_normalize = normalize;
+	update_gain();
+}
+
+void Player::set_replay_gain(std::optional<ReplayGain> const& replay_gain) {
+	m_replay_gain = replay_gain;
+	update_gain();
+}
+
+void Player::set_show_meters(bool const show) {
+	m_show_meters = show;
+	m_tap.set_enabled(m_show_meters || m_spectrum.is_enabled());
+}
+
+void Player::set_show_spectrum(bool const show) {
+	m_spectrum.set_enabled(show);
+	m_tap.set_enabled(m_show_meters || m_spectrum.is_enabled());
+}
+
+auto Player::load_track(Track& track) -> bool {
+	RIFF_PROFILE_ZONE(TrackLoad);
+	RIFF_PROFILE_LOAD(LoadTrack, track.path);
+	auto const was_playing = is_playing();
+	// small files are decoded once and played from memory: replays and Repeat::One loops cost no I/O or decoding
+	auto buffer = m_pcm_cache.get(track);
+	auto const opened = buffer ? m_source->bind_to(buffer.get()) : m_source->open_file_stream(track.path.c_str());
+	if (!opened) {
+		RIFF_PROFILE_LOAD_CANCEL();
+		track.status = Track::Status::Error;
+		return false;
+	}
+	m_buffer = std::move(buffer);
+	RIFF_PROFILE_LOAD(StreamOpen);
+
+	track.status = Track::Status::Ok;
+	track.duration = m_source->get_duration();
+	track.duration_label.clear();
+	capo::format_duration_to(track.duration_label, track.duration);
+
+	m_title = track.name;
+	m_duration_str = track.duration_label.c_str();
+	m_seeking = false;
+	set_replay_gain(track.replay_gain);
+	m_tap.attach(track.path, m_buffer);
+
+	if (was_playing) { play(); }
+	return true;
+}
+
+void Player::play() {
+	m_latency.on_play(m_source->get_cursor());
+	m_source->play();
+}
+
+void Player::unload_track() {
+	m_source->unbind();
+	m_buffer.reset();
+
+	m_title = blank_title_v;
+	m_duration_str = duration_0_str.c_str();
+	m_seeking = false;
+	set_replay_gain({});
+	m_tap.detach();
+}
+
+void Player::update_gain() {
+	auto gain = float(m_volume) * 0.01f;
+	if (m_replay_gain) {
+		switch (m_normalize) {
+		case Normalize::Track: gain *= std::pow(10.0f, m_replay_gain->track_db / 20.0f); break;
+		case Normalize::Album: gain *= std::pow(10.0f, m_replay_gain->album_db / 20.0f); break;
+		default: break;
+		}
+	}
+	m_source->set_gain(gain);
+	m_tap.set_gain(gain);
+}
+} // namespace riff
@@ -0,0 +1,101 @@
+#pragma once
+#include <capo/source.hpp>
+#include <klib/base_types.hpp>
+#include <klib/c_string.hpp>
+#include <level_meter.hpp>
+#include <normalize.hpp>
+#include <output_latency.hpp>
+#include <pcm_cache.hpp>
+#include <repeat.hpp>
+#include <spectrum.hpp>
+#include <track.hpp>
+
+namespace riff {
+class Player {
+  public:
+	struct IMediator : klib::Polymorphic {
+		virtual void skip_prev() = 0;
+		virtual void skip_next() = 0;
+		virtual void open_library() = 0;
+		// returns false if there is no active track or cover art is unavailable
+		virtual auto draw_active_cover(float size) -> bool = 0;
+	};
+
+	explicit Player(std::unique_ptr<capo::ISource> source);
+
+	[[nodiscard]] auto get_volume() const -> int { return m_volume; }
+	void set_volume(int volume);
+
+	[[nodiscard]] auto get_balance() const -> float { return m_source->get_pan(); }
+	void set_balance(float const balance) { m_source->set_pan(balance); }
+
+	[[nodiscard]] auto get_repeat() const -> Repeat { return m_repeat; }
+	void set_repeat(Repeat repeat);
+
+	[[nodiscard]] auto get_normalize() const -> Normalize { return m_normalize; }
+	void set_normalize(Normalize normalize);
+
+	void set_replay_gain(std::optional<ReplayGain> const& replay_gain);
+
+	[[nodiscard]] auto get_show_meters() const -> bool { return m_show_meters; }
+	void set_show_meters(bool show);
+
+	[[nodiscard]] auto get_show_spectrum() const -> bool { return m_spectrum.is_enabled(); }
+	void set_show_spectrum(bool show);
+
+	[[nodiscard]] auto get_cursor() const -> Time { return m_source->get_cursor(); }
+	void set_cursor(Time cursor) { m_source->set_cursor(cursor); }
+
+	[[nodiscard]] auto is_track_loaded() const -> bool { return m_source->is_bound(); }
+	auto load_track(Track& track) -> bool;
+	void unload_track();
+	void set_title(std::string_view const title) { m_title = title; }
+
+	[[nodiscard]] auto at_end() const -> bool { return m_source->at_end(); }
+	[[nodiscard]] auto is_playing() const -> bool { return m_source->is_playing(); }
+	void play();
+	void pause() { m_source->stop(); }
+
+	// call regularly while playing (once per frame / poll) to measure output latency
+	void sample_latency() { m_latency.sample(m_source->get_cursor(), m_source->is_playing()); }
+	[[nodiscard]] auto get_latency() const -> std::optional<OutputLatency::Estimate> { return m_latency.get_estimate(); }
+
+	void update(IMediator& mediator);
+
+  private:
+	static constexpr std::string_view blank_title_v{"[none]"};
+
+	void buttons(IMediator& mediator);
+	void sliders();
+	void seekbar();
+	void meters();
+	void spectrum();
+
+	void update_gain();
+
+	// declared before m_source: buffers must outlive the source they are bound to
+	PcmCache m_pcm_cache{};
+	// bound to m_source when the active track is played from memory
+	std::shared_ptr<capo::Buffer const> m_buffer{};
+	std::unique_ptr<capo::ISource> m_source{};
+
+	std::string m_title{blank_title_v};
+	klib::CString m_duration_str{};
+
+	float m_cursor{};
+	std::string m_cursor_str{};
+	bool m_seeking{};
+
+	Repeat m_repeat{Repeat::None};
+	OutputLatency m_latency{};
+
+	int m_volume{100};
+	Normalize m_normalize{Normalize::Off};
+	std::optional<ReplayGain> m_replay_gain{};
+
+	LevelMeter m_meter{};
+	Spectrum m_spectrum{};
+	PcmTap m_tap{{&m_meter, &m_spectrum}};
+	bool m_show_meters{};
+};
+} // namespace riff
@@ -0,0 +1,221 @@
+#include <log.hpp>
+#include <profiler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <numeric>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/vfs.h>
+#endif
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+using Micros = std::chrono::duration<std::int64_t, std::micro>;
+using Millis = std::chrono::duration<float, std::milli>;
+
+// coarse storage class of the filesystem holding path
+auto get_location(std::string_view const path) -> std::string_view {
+#if defined(__linux__)
+	struct statfs info{};
+	if (statfs(std::string{path}.c_str(), &info) != 0) { return "unknown"; }
+	switch (std::uint32_t(info.f_type)) {
+	case 0x6969:	 // NFS
+	case 0x517b:	 // SMB
+	case 0xff534d42: // CIFS
+	case 0xfe534d42: // SMB2
+		return "network";
+	case 0x65735546: return "fuse";
+	case 0x01021994: return "tmpfs";
+	default: return "local";
+	}
+#else
+	static_cast<void>(path);
+	return "local";
+#endif
+}
+
+auto get_load_key(std::string_view const path) -> std::string {
+	auto format = fs::path{path}.extension().generic_string();
+	if (!format.empty()) { format.erase(0, 1); }
+	std::ranges::transform(format, format.begin(), [](unsigned char const c) { return char(std::tolower(c)); });
+	if (format.empty()) { format = "?"; }
+	return std::format("{}/{}", format, get_location(path));
+}
+
+auto percentile(std::vector<float>& values, float const p) -> float {
+	if (values.empty()) { return 0.0f; }
+	auto const index = std::min(std::size_t(p * float(values.size())), values.size() - 1);
+	std::ranges::nth_element(values, values.begin() + std::ptrdiff_t(index));
+	return values.at(index);
+}
+
+auto thread_index() -> std::uint32_t {
+	static auto s_next = std::atomic<std::uint32_t>{};
+	thread_local auto const ret = s_next++;
+	return ret;
+}
+} // namespace
+
+auto Profiler::self() -> Profiler& {
+	static auto ret = Profiler{};
+	return ret;
+}
+
+void Profiler::next_frame() {
+	auto const now = Clock::now();
+	auto const start = std::exchange(m_frame_start, now);
+	if (start == Clock::time_point{}) { return; }
+	record(Zone::Frame, start, now);
+}
+
+void Profiler::record(Zone const zone, Clock::time_point const start, Clock::time_point const end) {
+	auto const lock = std::scoped_lock{m_mutex};
+	auto& window = m_windows.at(std::size_t(zone));
+	window.samples.at(window.next) = Millis{end - start}.count();
+	window.next = (window.next + 1) % window_v;
+	window.count = std::min(window.count + 1, window_v);
+
+	if (!m_tracing || m_trace.size() >= max_trace_events_v) { return; }
+	m_trace.push_back(TraceEvent{
+		.zone = zone,
+		.thread = thread_index(),
+		.start_us = std::chrono::duration_cast<Micros>(start - m_epoch).count(),
+		.duration_us = std::chrono::duration_cast<Micros>(end - start).count(),
+	});
+}
+
+auto Profiler::get_stats(Zone const zone) const -> Stats {
+	auto const lock = std::scoped_lock{m_mutex};
+	auto const& window = m_windows.at(std::size_t(zone));
+	if (window.count == 0) { return {}; }
+	auto ret = Stats{.last = window.samples.at((window.next + window_v - 1) % window_v)};
+	for (std::size_t i = 0; i < window.count; ++i) {
+		ret.mean += window.samples.at(i);
+		ret.max = std::max(ret.max, window.samples.at(i));
+	}
+	ret.mean /= float(window.count);
+	return ret;
+}
+
+void Profiler::copy_history(Zone const zone, std::span<float, window_v> out) const {
+	auto const lock = std::scoped_lock{m_mutex};
+	auto const& window = m_windows.at(std::size_t(zone));
+	for (std::size_t i = 0; i < window_v; ++i) { out[i] = window.samples.at((window.next + i) % window_v); }
+}
+
+void Profiler::mark_load(LoadStage const stage, std::string_view const path) {
+	auto const now = Clock::now();
+	auto const lock = std::scoped_lock{m_mutex};
+	auto& pending = m_pending_load;
+	if (stage == LoadStage::FirstAudio) {
+		if (pending.last == LoadStage::StreamOpen) { complete_load(now); }
+		return;
+	}
+	if (pending.last == LoadStage::COUNT_ || stage <= pending.last) { pending = PendingLoad{}; }
+	pending.marks.at(std::size_t(stage)) = now;
+	pending.last = stage;
+	if (!path.empty()) { pending.key = get_load_key(path); }
+}
+
+void Profiler::cancel_load() {
+	auto const lock = std::scoped_lock{m_mutex};
+	m_pending_load = PendingLoad{};
+}
+
+auto Profiler::get_load_reports() const -> std::vector<LoadReport> {
+	auto const lock = std::scoped_lock{m_mutex};
+	auto ret = std::vector<LoadReport>{};
+	ret.reserve(m_load_samples.size());
+	auto values = std::vector<float>{};
+	for (auto const& [key, samples] : m_load_samples) {
+		auto report = LoadReport{.key = key, .count = samples.size()};
+		auto const collect = [&](std::size_t const index) {
+			values.clear();
+			for (auto const& sample : samples) { values.push_back(sample.at(index)); }
+		};
+		for (std::size_t stage = 0; stage < report.stage_p50.size(); ++stage) {
+			collect(stage);
+			report.stage_p50.at(stage) = percentile(values, 0.5f);
+		}
+		values.clear();
+		for (auto const& sample : samples) { values.push_back(std::accumulate(sample.begin(), sample.end(), 0.0f)); }
+		report.p50 = percentile(values, 0.5f);
+		report.p99 = percentile(values, 0.99f);
+		ret.push_back(std::move(report));
+	}
+	return ret;
+}
+
+void Profiler::log_load_reports() const {
+	for (auto const& report : get_load_reports()) {
+		auto stages = std::string{};
+		for (auto stage = LoadStage::PlayTrack; stage < LoadStage::COUNT_; stage = LoadStage(int(stage) + 1)) {
+			std::format_to(std::back_inserter(stages), " {} {:.1f}", load_stage_name_v[stage],
+						   report.stage_p50.at(std::size_t(stage)));
+		}
+		log.info("time to first audio [{}]: n={} p50={:.1f}ms p99={:.1f}ms, stage p50s:{}", report.key, report.count,
+				 report.p50, report.p99, stages);
+	}
+}
+
+void Profiler::complete_load(Clock::time_point const now) {
+	auto& pending = m_pending_load;
+	pending.marks.back() = now;
+	auto sample = LoadSample{};
+	auto previous = Clock::time_point{};
+	for (std::size_t i = 0; i < sample.size(); ++i) {
+		auto const mark = pending.marks.at(i);
+		if (mark == Clock::time_point{}) { continue; }
+		if (previous != Clock::time_point{}) { sample.at(i) = Millis{mark - previous}.count(); }
+		previous = mark;
+	}
+	auto& samples = m_load_samples[pending.key];
+	if (samples.size() >= max_load_samples_v) { samples.erase(samples.begin()); }
+	samples.push_back(sample);
+	pending = PendingLoad{};
+}
+
+auto Profiler::is_tracing() const -> bool {
+	auto const lock = std::scoped_lock{m_mutex};
+	return m_tracing;
+}
+
+void Profiler::start_trace() {
+	auto const lock = std::scoped_lock{m_mutex};
+	m_trace.clear();
+	m_tracing = true;
+}
+
+auto Profiler::stop_trace(std::string_view const path) -> bool {
+	auto trace = std::vector<TraceEvent>{};
+	{
+		auto const lock = std::scoped_lock{m_mutex};
+		m_tracing = false;
+		std::swap(trace, m_trace);
+	}
+
+	auto file = std::ofstream{std::string{path}};
+	if (!file.is_open()) {
+		log.error("failed to write trace: {}", path);
+		return false;
+	}
+	file << "{\"traceEvents\":[";
+	auto first = true;
+	for (auto const& event : trace) {
+		file << std::format("{}\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{}}}",
+							first ? "" : ",", zone_name_v[event.zone], event.thread, event.start_us,
+							event.duration_us);
+		first = false;
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	log.info("{} trace events written to: {}", trace.size(), path);
+	return true;
+}
+} // namespace riff
@@ -0,0 +1,145 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <klib/enum_array.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace riff {
+class Profiler : public klib::Pinned {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	enum class Zone : std::int8_t { Frame, PlayerUpdate, TracklistRender, ConfigSave, DropIngest, TrackLoad, COUNT_ };
+
+	static constexpr auto zone_name_v = klib::EnumArray<Zone, std::string_view>{
+		"frame", "player_update", "tracklist_render", "config_save", "drop_ingest", "track_load",
+	};
+
+	// time to first audio: click in the tracklist through to the output consuming the first buffer
+	enum class LoadStage : std::int8_t { Click, PlayTrack, LoadTrack, StreamOpen, FirstAudio, COUNT_ };
+
+	static constexpr auto load_stage_name_v = klib::EnumArray<LoadStage, std::string_view>{
+		"click", "play", "load", "open", "audio",
+	};
+
+#if defined(RIFF_PROFILE)
+	static constexpr bool enabled_v{true};
+#else
+	static constexpr bool enabled_v{false};
+#endif
+
+	static constexpr std::size_t window_v{240};
+	static constexpr std::size_t max_trace_events_v{1 << 20};
+	static constexpr std::size_t max_load_samples_v{512};
+
+	class Scope : public klib::Pinned {
+	  public:
+		explicit Scope(Zone const zone) : m_zone(zone), m_start(Clock::now()) {}
+		~Scope() { self().record(m_zone, m_start, Clock::now()); }
+
+	  private:
+		Zone m_zone;
+		Clock::time_point m_start;
+	};
+
+	// milliseconds over the last window_v samples
+	struct Stats {
+		float last{};
+		float mean{};
+		float max{};
+	};
+
+	// milliseconds per format and storage location, stage values are the time since the previous stage
+	struct LoadReport {
+		std::string key{};
+		std::size_t count{};
+		float p50{};
+		float p99{};
+		std::array<float, std::size_t(LoadStage::COUNT_)> stage_p50{};
+	};
+
+	[[nodiscard]] static auto self() -> Profiler&;
+
+	void next_frame();
+	void record(Zone zone, Clock::time_point start, Clock::time_point end);
+
+	[[nodiscard]] auto get_stats(Zone zone) const -> Stats;
+	// oldest first
+	void copy_history(Zone zone, std::span<float, window_v> out) const;
+
+	// a stage at or before the last marked one starts a new measurement
+	void mark_load(LoadStage stage, std::string_view path = {});
+	void cancel_load();
+	[[nodiscard]] auto get_load_reports() const -> std::vector<LoadReport>;
+	void log_load_reports() const;
+
+	[[nodiscard]] auto is_tracing() const -> bool;
+	void start_trace();
+	// writes Chrome trace event JSON (chrome://tracing, Perfetto)
+	auto stop_trace(std::string_view path) -> bool;
+
+	void update(bool& open);
+
+	std::string trace_path{"riff_trace.json"};
+
+  private:
+	struct Window {
+		std::array<float, window_v> samples{};
+		std::size_t next{};
+		std::size_t count{};
+	};
+
+	struct TraceEvent {
+		Zone zone{};
+		std::uint32_t thread{};
+		std::int64_t start_us{};
+		std::int64_t duration_us{};
+	};
+
+	using LoadSample = std::array<float, std::size_t(LoadStage::COUNT_)>;
+
+	struct PendingLoad {
+		std::array<Clock::time_point, std::size_t(LoadStage::COUNT_)> marks{};
+		std::string key{};
+		LoadStage last{LoadStage::COUNT_};
+	};
+
+	Profiler() = default;
+
+	void complete_load(Clock::time_point now);
+
+	mutable std::mutex m_mutex{};
+	std::array<Window, std::size_t(Zone::COUNT_)> m_windows{};
+	std::vector<TraceEvent> m_trace{};
+	bool m_tracing{};
+
+	PendingLoad m_pending_load{};
+	std::map<std::string, std::vector<LoadSample>, std::less<>> m_load_samples{};
+
+	Clock::time_point m_epoch{Clock::now()};
+	Clock::time_point m_frame_start{};
+};
+} // namespace riff
+
+#if defined(RIFF_PROFILE)
+#define RIFF_PROFILE_CONCAT_(a, b) a##b
+#define RIFF_PROFILE_CONCAT(a, b) RIFF_PROFILE_CONCAT_(a, b)
+#define RIFF_PROFILE_ZONE(zone)                                                                                        \
+	::riff::Profiler::Scope const RIFF_PROFILE_CONCAT(riff_profile_zone_, __LINE__) { ::riff::Profiler::Zone::zone }
+#define RIFF_PROFILE_FRAME() ::riff::Profiler::self().next_frame()
+#define RIFF_PROFILE_LOAD(stage, ...)                                                                                  \
+	::riff::Profiler::self().mark_load(::riff::Profiler::LoadStage::stage __VA_OPT__(, ) __VA_ARGS__)
+#define RIFF_PROFILE_LOAD_CANCEL() ::riff::Profiler::self().cancel_load()
+#else
+#define RIFF_PROFILE_ZONE(zone)
+#define RIFF_PROFILE_FRAME()
+#define RIFF_PROFILE_LOAD(stage, ...)
+#define RIFF_PROFILE_LOAD_CANCEL()
+#endif
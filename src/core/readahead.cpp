@@ -0,0 +1,63 @@
+#include <readahead.hpp>
+#include <algorithm>
+#include <array>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace riff {
+namespace {
+#if defined(_WIN32)
+void warm(std::string const& path) {
+	auto file = std::ifstream{path, std::ios::binary};
+	auto buffer = std::array<char, 64 * 1024>{};
+	for (auto remain = Readahead::budget_v; file && remain > 0;) {
+		file.read(buffer.data(), std::streamsize(std::min<std::uint64_t>(remain, buffer.size())));
+		remain -= std::min<std::uint64_t>(remain, std::uint64_t(file.gcount()));
+	}
+}
+#else
+void warm(std::string const& path) {
+	auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT
+	if (fd < 0) { return; }
+#if defined(POSIX_FADV_WILLNEED)
+	// asynchronous: returns once the reads have been queued, failure only costs the hint
+	::posix_fadvise(fd, 0, off_t(Readahead::budget_v), POSIX_FADV_WILLNEED);
+#else
+	auto buffer = std::array<char, 64 * 1024>{};
+	for (auto remain = Readahead::budget_v; remain > 0;) {
+		auto const count = ::read(fd, buffer.data(), std::min<std::uint64_t>(remain, buffer.size()));
+		if (count <= 0) { break; }
+		remain -= std::uint64_t(count);
+	}
+#endif
+	::close(fd);
+}
+#endif
+} // namespace
+
+Readahead::Readahead() {
+	m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+}
+
+void Readahead::prefetch(std::string_view const path) {
+	auto lock = std::scoped_lock{m_mutex};
+	m_pending = std::string{path};
+	m_cv.notify_one();
+}
+
+void Readahead::run(std::stop_token const& stop) {
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (!m_cv.wait(lock, stop, [this] { return m_pending.has_value(); })) { return; }
+		auto const path = std::move(*m_pending);
+		m_pending.reset();
+		lock.unlock();
+		warm(path);
+	}
+}
+} // namespace riff
@@ -0,0 +1,31 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace riff {
+// Warms the page cache for the head of a file that is about to be played, so its first reads do not stall on slow
+// storage (NFS, USB). Files are opened on a worker thread: posix_fadvise(WILLNEED) on POSIX, else the head is read.
+class Readahead : public klib::Pinned {
+  public:
+	static constexpr std::uint64_t budget_v{8 * 1024 * 1024};
+
+	Readahead();
+
+	// supersedes a pending request that has not started yet
+	void prefetch(std::string_view path);
+
+  private:
+	void run(std::stop_token const& stop);
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::optional<std::string> m_pending{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
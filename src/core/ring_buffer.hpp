@@ -0,0 +1,44 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+
+namespace riff {
+// Lock-free single producer / single consumer ring buffer.
+template <typename Type, std::size_t Capacity>
+class RingBuffer {
+	static_assert(std::has_single_bit(Capacity));
+
+  public:
+	static constexpr auto capacity_v = Capacity;
+
+	// returns the number of elements written, excess is dropped
+	auto push(std::span<Type const> const in) -> std::size_t {
+		auto const write = m_write.load(std::memory_order_relaxed);
+		auto const read = m_read.load(std::memory_order_acquire);
+		auto const count = std::min(in.size(), Capacity - (write - read));
+		for (std::size_t i = 0; i < count; ++i) { m_data[(write + i) & mask_v] = in[i]; }
+		m_write.store(write + count, std::memory_order_release);
+		return count;
+	}
+
+	// returns the number of elements read
+	auto pop(std::span<Type> const out) -> std::size_t {
+		auto const read = m_read.load(std::memory_order_relaxed);
+		auto const write = m_write.load(std::memory_order_acquire);
+		auto const count = std::min(out.size(), write - read);
+		for (std::size_t i = 0; i < count; ++i) { out[i] = m_data[(read + i) & mask_v]; }
+		m_read.store(read + count, std::memory_order_release);
+		return count;
+	}
+
+  private:
+	static constexpr auto mask_v = Capacity - 1;
+
+	std::array<Type, Capacity> m_data{};
+	alignas(64) std::atomic<std::size_t> m_write{};
+	alignas(64) std::atomic<std::size_t> m_read{};
+};
+} // namespace riff
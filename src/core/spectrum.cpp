@@ -0,0 +1,111 @@
+#include <spectrum.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace riff {
+namespace {
+constexpr auto release_v = 0.85f;
+} // namespace
+
+Spectrum::Spectrum() {
+	for (std::size_t i = 0; i < fft_size_v; ++i) {
+		auto const phase = 2.0 * std::numbers::pi * double(i) / double(fft_size_v - 1);
+		m_window.at(i) = float(0.5 * (1.0 - std::cos(phase)));
+	}
+}
+
+// the analysis thread is started on first enable: players without a UI never spawn it
+void Spectrum::set_enabled(bool const enabled) {
+	if (enabled && !m_thread.joinable()) {
+		m_thread = std::jthread{[this](std::stop_token const& stop) { run(stop); }};
+	}
+	auto lock = std::scoped_lock{m_mutex};
+	if (enabled == m_enabled) { return; }
+	m_enabled = enabled;
+	m_cv.notify_one();
+}
+
+void Spectrum::copy_bands(std::span<float, bands_v> const out) const {
+	for (std::size_t i = 0; i < bands_v; ++i) { out[i] = m_bands.at(i).load(std::memory_order_relaxed); }
+}
+
+void Spectrum::write(std::span<float const> const interleaved, std::uint8_t const channels,
+					 std::uint32_t const sample_rate) {
+	if (!is_enabled() || channels == 0) { return; }
+	auto const frames = interleaved.size() / channels;
+	m_mono.resize(frames);
+	auto const scale = 1.0f / float(channels);
+	for (std::size_t f = 0; f < frames; ++f) {
+		auto const frame = interleaved.subspan(f * channels, channels);
+		auto sum = 0.0f;
+		for (auto const sample : frame) { sum += sample; }
+		m_mono[f] = sum * scale;
+	}
+	m_sample_rate.store(sample_rate, std::memory_order_relaxed);
+	m_ring.push(m_mono);
+}
+
+void Spectrum::reset() { m_reset.store(true, std::memory_order_relaxed); }
+
+void Spectrum::run(std::stop_token const& stop) {
+	auto next = Clock::now();
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (!m_cv.wait(lock, stop, [this] { return m_enabled.load(); })) { return; }
+		lock.unlock();
+
+		analyze();
+
+		next += hop_v;
+		auto const now = Clock::now();
+		if (next < now) { next = now; }
+		lock.lock();
+		m_cv.wait_until(lock, stop, next, [this] { return !m_enabled; });
+	}
+}
+
+void Spectrum::analyze() {
+	if (m_reset.exchange(false, std::memory_order_relaxed)) {
+		m_history.fill(0.0f);
+		m_smoothed.fill(0.0f);
+	}
+
+	auto chunk = std::array<float, 256>{};
+	for (auto count = m_ring.pop(chunk); count > 0; count = m_ring.pop(chunk)) {
+		for (std::size_t i = 0; i < count; ++i) {
+			m_history.at(m_history_head) = chunk.at(i);
+			m_history_head = (m_history_head + 1) % fft_size_v;
+		}
+	}
+
+	for (std::size_t i = 0; i < fft_size_v; ++i) {
+		m_real.at(i) = m_history.at((m_history_head + i) % fft_size_v) * m_window.at(i);
+	}
+	m_imag.fill(0.0f);
+	m_fft.transform(m_real, m_imag);
+
+	auto const sample_rate = m_sample_rate.load(std::memory_order_relaxed);
+	if (sample_rate == 0) { return; }
+	auto const bin_width = float(sample_rate) / float(fft_size_v);
+	auto const max_freq = std::min(max_freq_v, 0.5f * float(sample_rate));
+	auto const ratio = std::pow(max_freq / min_freq_v, 1.0f / float(bands_v));
+	auto const norm = 4.0f / float(fft_size_v); // Hann window coherent gain (0.5) and single-sided spectrum
+	auto low = min_freq_v;
+	for (std::size_t band = 0; band < bands_v; ++band) {
+		auto const high = low * ratio;
+		auto const first = std::size_t(low / bin_width);
+		auto const last = std::clamp(std::size_t(high / bin_width), first, (fft_size_v / 2) - 1);
+		auto power = 0.0f;
+		for (auto bin = first; bin <= last; ++bin) {
+			power = std::max(power, (m_real.at(bin) * m_real.at(bin)) + (m_imag.at(bin) * m_imag.at(bin)));
+		}
+		auto const db = 10.0f * std::log10(std::max(power * norm * norm, 1e-12f));
+		auto const value = std::clamp((db - floor_db_v) / -floor_db_v, 0.0f, 1.0f);
+		auto& smoothed = m_smoothed.at(band);
+		smoothed = std::max(value, smoothed * release_v);
+		m_bands.at(band).store(smoothed, std::memory_order_relaxed);
+		low = high;
+	}
+}
+} // namespace riff
@@ -0,0 +1,59 @@
+#pragma once
+#include <fft.hpp>
+#include <pcm_tap.hpp>
+#include <ring_buffer.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace riff {
+class Spectrum : public PcmTap::ISink, public klib::Pinned {
+  public:
+	static constexpr std::size_t fft_size_v{2048};
+	static constexpr std::size_t bands_v{48};
+	static constexpr auto hop_v{std::chrono::milliseconds{1000 / 60}};
+	static constexpr auto min_freq_v{30.0f};
+	static constexpr auto max_freq_v{18000.0f};
+	static constexpr auto floor_db_v{-80.0f};
+
+	Spectrum();
+
+	void set_enabled(bool enabled);
+	[[nodiscard]] auto is_enabled() const -> bool { return m_enabled; }
+
+	// normalized [0, 1] band magnitudes, log spaced between min_freq_v and max_freq_v
+	void copy_bands(std::span<float, bands_v> out) const;
+
+	void write(std::span<float const> interleaved, std::uint8_t channels, std::uint32_t sample_rate) final;
+	void reset() final;
+
+  private:
+	void run(std::stop_token const& stop);
+	void analyze();
+
+	// tap thread
+	RingBuffer<float, 4 * fft_size_v> m_ring{};
+	std::vector<float> m_mono{};
+	std::atomic<std::uint32_t> m_sample_rate{};
+	std::atomic<bool> m_reset{};
+
+	// analysis thread
+	Fft m_fft{fft_size_v};
+	std::array<float, fft_size_v> m_window{};
+	std::array<float, fft_size_v> m_history{};
+	std::size_t m_history_head{};
+	std::array<float, fft_size_v> m_real{};
+	std::array<float, fft_size_v> m_imag{};
+	std::array<float, bands_v> m_smoothed{};
+
+	std::array<std::atomic<float>, bands_v> m_bands{};
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::atomic<bool> m_enabled{};
+
+	std::jthread m_thread{};
+};
+} // namespace riff
@@ -0,0 +1,450 @@
+#include <tag_reader.hpp>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace riff {
+namespace {
+using Bytes = std::span<std::byte const>;
+
+constexpr std::size_t head_size_v{64 * 1024};
+// larger tags are almost always embedded artwork
+constexpr std::size_t max_read_size_v{16 * 1024 * 1024};
+constexpr std::size_t max_flac_blocks_v{64};
+constexpr int flac_vorbis_comment_v{4};
+constexpr int flac_picture_v{6};
+
+// positioned reads: the head is read once and slices of it are served without further IO.
+class File {
+  public:
+	explicit File(std::string const& path) : m_file(path, std::ios::binary | std::ios::ate) {
+		if (!m_file) { return; }
+		m_size = std::uint64_t(m_file.tellg());
+		m_head.resize(std::size_t(std::min<std::uint64_t>(m_size, head_size_v)));
+		m_file.seekg(0);
+		m_file.read(reinterpret_cast<char*>(m_head.data()), std::streamsize(m_head.size())); // NOLINT
+		m_head.resize(std::size_t(m_file.gcount()));
+	}
+
+	explicit operator bool() const { return m_file.is_open(); }
+
+	[[nodiscard]] auto get_size() const -> std::uint64_t { return m_size; }
+
+	// returned bytes are valid until the next call, and may be fewer than count at the end of the file
+	[[nodiscard]] auto read(std::uint64_t const offset, std::size_t count) -> Bytes {
+		if (offset >= m_size) { return {}; }
+		count = std::size_t(std::min<std::uint64_t>(count, m_size - offset));
+		if (offset + count <= m_head.size()) { return Bytes{m_head}.subspan(std::size_t(offset), count); }
+		if (count > max_read_size_v) { return {}; }
+		m_scratch.resize(count);
+		m_file.clear();
+		m_file.seekg(std::streamoff(offset));
+		m_file.read(reinterpret_cast<char*>(m_scratch.data()), std::streamsize(count)); // NOLINT
+		return Bytes{m_scratch}.first(std::size_t(m_file.gcount()));
+	}
+
+  private:
+	std::ifstream m_file;
+	std::uint64_t m_size{};
+	std::vector<std::byte> m_head{};
+	std::vector<std::byte> m_scratch{};
+};
+
+[[nodiscard]] auto matches(Bytes const bytes, std::string_view const magic, std::size_t const at = 0) -> bool {
+	if (at + magic.size() > bytes.size()) { return false; }
+	return std::ranges::equal(bytes.subspan(at, magic.size()), magic, {}, {}, [](char c) { return std::byte(c); });
+}
+
+[[nodiscard]] auto le32(Bytes const bytes, std::size_t const at) -> std::uint32_t {
+	auto ret = std::uint32_t{};
+	for (std::size_t i = 0; i < 4; ++i) { ret |= std::uint32_t(bytes[at + i]) << (8 * i); }
+	return ret;
+}
+
+[[nodiscard]] auto be(Bytes const bytes, std::size_t const at, std::size_t const count) -> std::uint32_t {
+	auto ret = std::uint32_t{};
+	for (std::size_t i = 0; i < count; ++i) { ret = (ret << 8) | std::uint32_t(bytes[at + i]); }
+	return ret;
+}
+
+[[nodiscard]] auto syncsafe(Bytes const bytes, std::size_t const at) -> std::uint32_t {
+	auto ret = std::uint32_t{};
+	for (std::size_t i = 0; i < 4; ++i) { ret = (ret << 7) | (std::uint32_t(bytes[at + i]) & 0x7f); }
+	return ret;
+}
+
+enum class Encoding : std::int8_t { Latin1, Utf16, Utf16Be, Utf8 };
+
+void append_utf8(std::string& out, std::uint32_t const code) {
+	if (code < 0x80) {
+		out.push_back(char(code));
+	} else if (code < 0x800) {
+		out.push_back(char(0xc0 | (code >> 6)));
+		out.push_back(char(0x80 | (code & 0x3f)));
+	} else if (code < 0x10000) {
+		out.push_back(char(0xe0 | (code >> 12)));
+		out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+		out.push_back(char(0x80 | (code & 0x3f)));
+	} else {
+		out.push_back(char(0xf0 | (code >> 18)));
+		out.push_back(char(0x80 | ((code >> 12) & 0x3f)));
+		out.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+		out.push_back(char(0x80 | (code & 0x3f)));
+	}
+}
+
+void decode_utf16(std::string& out, Bytes text, bool big_endian) {
+	if (text.size() >= 2) {
+		auto const bom = be(text, 0, 2);
+		if (bom == 0xfeff || bom == 0xfffe) {
+			big_endian = bom == 0xfeff;
+			text = text.subspan(2);
+		}
+	}
+	auto const unit = [&](std::size_t const i) {
+		auto const a = std::uint32_t(text[i]);
+		auto const b = std::uint32_t(text[i + 1]);
+		return big_endian ? (a << 8) | b : (b << 8) | a;
+	};
+	for (std::size_t i = 0; i + 1 < text.size(); i += 2) {
+		auto code = unit(i);
+		if (code == 0) { break; }
+		if (code >= 0xd800 && code < 0xdc00 && i + 3 < text.size()) {
+			auto const low = unit(i + 2);
+			if (low >= 0xdc00 && low < 0xe000) {
+				code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+				i += 2;
+			}
+		}
+		append_utf8(out, code);
+	}
+}
+
+// the first value of a (possibly null separated) text field, trailing padding trimmed
+[[nodiscard]] auto decode(Bytes const text, Encoding const encoding) -> std::string {
+	auto ret = std::string{};
+	switch (encoding) {
+	case Encoding::Utf16:
+	case Encoding::Utf16Be: decode_utf16(ret, text, encoding == Encoding::Utf16Be); break;
+	case Encoding::Latin1:
+		for (auto const byte : text) {
+			if (byte == std::byte{}) { break; }
+			append_utf8(ret, std::uint32_t(byte));
+		}
+		break;
+	case Encoding::Utf8: {
+		auto const str = std::string_view{reinterpret_cast<char const*>(text.data()), text.size()}; // NOLINT
+		ret = str.substr(0, str.find('\0'));
+		break;
+	}
+	}
+	while (!ret.empty() && ret.back() == ' ') { ret.pop_back(); }
+	return ret;
+}
+
+// "3/12" => 3
+[[nodiscard]] auto parse_track_number(std::string_view const text) -> std::uint32_t {
+	auto ret = std::uint32_t{};
+	std::from_chars(text.data(), text.data() + text.size(), ret);
+	return ret;
+}
+
+// fields already set by a preferred source are kept
+void assign(std::string& out, Bytes const text, Encoding const encoding) {
+	if (out.empty()) { out = decode(text, encoding); }
+}
+
+void assign_track(std::uint32_t& out, Bytes const text, Encoding const encoding) {
+	if (out == 0) { out = parse_track_number(decode(text, encoding)); }
+}
+
+// removes the 0x00 inserted after every 0xff
+[[nodiscard]] auto resync(Bytes const bytes, std::vector<std::byte>& storage) -> Bytes {
+	storage.clear();
+	for (std::size_t i = 0; i < bytes.size(); ++i) {
+		storage.push_back(bytes[i]);
+		if (bytes[i] == std::byte{0xff} && i + 1 < bytes.size() && bytes[i + 1] == std::byte{}) { ++i; }
+	}
+	return storage;
+}
+
+void parse_id3v2_frame(Tags& out, std::string_view const id, Bytes const data) {
+	if (data.empty()) { return; }
+	auto const encoding = Encoding(std::min(std::to_integer<int>(data[0]), int(Encoding::Utf8)));
+	auto const text = data.subspan(1);
+	if (id == "TIT2" || id == "TT2") {
+		assign(out.title, text, encoding);
+	} else if (id == "TPE1" || id == "TP1") {
+		assign(out.artist, text, encoding);
+	} else if (id == "TALB" || id == "TAL") {
+		assign(out.album, text, encoding);
+	} else if (id == "TRCK" || id == "TRK") {
+		assign_track(out.track_number, text, encoding);
+	}
+}
+
+// tag: the whole ID3v2 tag including its 10 byte header, func(id, data) for each frame
+template <typename F>
+void for_each_id3v2_frame(Bytes const tag, F func) {
+	if (!matches(tag, "ID3") || tag.size() < 10) { return; }
+	auto const version = std::to_integer<int>(tag[3]);
+	auto const flags = std::to_integer<int>(tag[5]);
+	if (version < 2 || version > 4) { return; }
+	auto body = tag.subspan(10, std::min<std::size_t>(syncsafe(tag, 6), tag.size() - 10));
+
+	auto storage = std::vector<std::byte>{};
+	if ((flags & 0x80) != 0 && version < 4) { body = resync(body, storage); }
+	if ((flags & 0x40) != 0 && version > 2 && body.size() >= 4) {
+		auto const size = version == 3 ? be(body, 0, 4) + 4 : syncsafe(body, 0);
+		body = body.subspan(std::min<std::size_t>(size, body.size()));
+	}
+
+	auto const id_size = version == 2 ? 3uz : 4uz;
+	auto const header_size = version == 2 ? 6uz : 10uz;
+	auto frame_storage = std::vector<std::byte>{};
+	while (body.size() >= header_size && body[0] != std::byte{}) {
+		auto const id = std::string_view{reinterpret_cast<char const*>(body.data()), id_size}; // NOLINT
+		auto const size = version == 2 ? be(body, 3, 3) : (version == 3 ? be(body, 4, 4) : syncsafe(body, 4));
+		auto const frame_flags = version == 2 ? 0u : be(body, 8, 2);
+		if (size > body.size() - header_size) { break; }
+		auto data = body.subspan(header_size, size);
+		body = body.subspan(header_size + size);
+
+		if (version == 3) {
+			// compressed or encrypted
+			if ((frame_flags & 0xc0) != 0) { continue; }
+		} else if (version == 4) {
+			if ((frame_flags & 0x0c) != 0) { continue; }
+			if ((frame_flags & 0x01) != 0) { data = data.subspan(std::min(data.size(), 4uz)); }
+			if ((frame_flags & 0x02) != 0) { data = resync(data, frame_storage); }
+		}
+		func(id, data);
+	}
+}
+
+void parse_id3v2(Tags& out, Bytes const tag) {
+	for_each_id3v2_frame(tag, [&out](std::string_view const id, Bytes const data) {
+		if (id.starts_with('T')) { parse_id3v2_frame(out, id, data); }
+	});
+}
+
+void parse_vorbis_comment(Tags& out, Bytes block) {
+	auto const take = [&block](std::size_t const count) {
+		auto const ret = block.first(std::min(count, block.size()));
+		block = block.subspan(ret.size());
+		return ret;
+	};
+	if (block.size() < 4) { return; }
+	take(4 + std::size_t(le32(block, 0))); // vendor string
+	if (block.size() < 4) { return; }
+	auto const count = le32(block, 0);
+	take(4);
+	for (std::uint32_t i = 0; i < count && block.size() >= 4; ++i) {
+		auto const comment = take(4 + std::size_t(le32(block, 0))).subspan(4);
+		auto const text = std::string_view{reinterpret_cast<char const*>(comment.data()), comment.size()}; // NOLINT
+		auto const equals = text.find('=');
+		if (equals == std::string_view::npos) { continue; }
+		auto key = std::string{text.substr(0, equals)};
+		std::ranges::transform(key, key.begin(), [](unsigned char const c) { return char(std::toupper(c)); });
+		auto const value = comment.subspan(equals + 1);
+		if (key == "TITLE") {
+			assign(out.title, value, Encoding::Utf8);
+		} else if (key == "ARTIST") {
+			assign(out.artist, value, Encoding::Utf8);
+		} else if (key == "ALBUM") {
+			assign(out.album, value, Encoding::Utf8);
+		} else if (key == "TRACKNUMBER") {
+			assign_track(out.track_number, value, Encoding::Utf8);
+		}
+	}
+}
+
+void parse_riff_info(Tags& out, Bytes list) {
+	// list: "INFO" followed by sub chunks
+	if (list.size() < 4) { return; }
+	list = list.subspan(4);
+	while (list.size() >= 8) {
+		auto const size = std::min<std::size_t>(le32(list, 4), list.size() - 8);
+		auto const value = list.subspan(8, size);
+		if (matches(list, "INAM")) {
+			assign(out.title, value, Encoding::Utf8);
+		} else if (matches(list, "IART")) {
+			assign(out.artist, value, Encoding::Utf8);
+		} else if (matches(list, "IPRD")) {
+			assign(out.album, value, Encoding::Utf8);
+		} else if (matches(list, "ITRK") || matches(list, "IPRT")) {
+			assign_track(out.track_number, value, Encoding::Utf8);
+		}
+		list = list.subspan(std::min(list.size(), 8 + size + (size & 1)));
+	}
+}
+
+// returns the offset past the tag, or 0 if there is none
+template <typename F>
+auto read_id3v2(File& file, std::uint64_t const offset, F func) -> std::uint64_t {
+	auto const header = file.read(offset, 10);
+	if (header.size() < 10 || !matches(header, "ID3")) { return 0; }
+	auto const has_footer = (std::to_integer<int>(header[5]) & 0x10) != 0;
+	auto const size = 10 + std::size_t(syncsafe(header, 6));
+	func(file.read(offset, size));
+	return offset + size + (has_footer ? 10 : 0);
+}
+
+// func(type, offset, size) for each metadata block until it returns false
+template <typename F>
+void for_each_flac_block(File& file, std::uint64_t offset, F func) {
+	if (!matches(file.read(offset, 4), "fLaC")) { return; }
+	offset += 4;
+	for (std::size_t i = 0; i < max_flac_blocks_v; ++i) {
+		auto const header = file.read(offset, 4);
+		if (header.size() < 4) { return; }
+		auto const is_last = (std::to_integer<int>(header[0]) & 0x80) != 0;
+		auto const type = std::to_integer<int>(header[0]) & 0x7f;
+		auto const size = std::size_t(be(header, 1, 3));
+		offset += 4;
+		if (!func(type, offset, size) || is_last) { return; }
+		offset += size;
+	}
+}
+
+// func(chunk, offset, size): chunk holds at least the 8 byte chunk header
+template <typename F>
+void for_each_riff_chunk(File& file, F func) {
+	auto const header = file.read(0, 12);
+	if (!matches(header, "RIFF") || !matches(header, "WAVE", 8)) { return; }
+	auto offset = std::uint64_t{12};
+	while (offset + 8 <= file.get_size()) {
+		auto const chunk = file.read(offset, 12);
+		if (chunk.size() < 8) { return; }
+		auto const size = std::uint64_t(le32(chunk, 4));
+		func(chunk, offset + 8, std::size_t(size));
+		offset += 8 + size + (size & 1);
+	}
+}
+
+[[nodiscard]] auto is_id3_chunk(Bytes const chunk) -> bool { return matches(chunk, "id3 ") || matches(chunk, "ID3 "); }
+
+void read_flac(Tags& out, File& file, std::uint64_t const offset) {
+	for_each_flac_block(file, offset, [&](int const type, std::uint64_t const block, std::size_t const size) {
+		if (type != flac_vorbis_comment_v) { return true; }
+		parse_vorbis_comment(out, file.read(block, size));
+		return false;
+	});
+}
+
+void read_riff(Tags& out, File& file) {
+	for_each_riff_chunk(file, [&](Bytes const chunk, std::uint64_t const offset, std::size_t const size) {
+		if (matches(chunk, "LIST") && matches(chunk, "INFO", 8)) {
+			parse_riff_info(out, file.read(offset, size));
+		} else if (is_id3_chunk(chunk)) {
+			parse_id3v2(out, file.read(offset, size));
+		}
+	});
+}
+
+void read_id3v1(Tags& out, File& file) {
+	if (file.get_size() < 128) { return; }
+	auto const tag = file.read(file.get_size() - 128, 128);
+	if (tag.size() < 128 || !matches(tag, "TAG")) { return; }
+	assign(out.title, tag.subspan(3, 30), Encoding::Latin1);
+	assign(out.artist, tag.subspan(33, 30), Encoding::Latin1);
+	assign(out.album, tag.subspan(63, 30), Encoding::Latin1);
+	// ID3v1.1: zero byte followed by the track number at the end of the comment
+	if (tag[125] == std::byte{} && out.track_number == 0) { out.track_number = std::to_integer<std::uint32_t>(tag[126]); }
+}
+
+// keeps the front cover, or else the first picture seen
+class PictureSelector {
+  public:
+	[[nodiscard]] auto is_done() const -> bool { return m_front; }
+
+	void offer(int const type, Bytes const data) {
+		if (m_front || data.empty() || (type != front_cover_v && !m_bytes.empty())) { return; }
+		m_bytes.assign(data.begin(), data.end());
+		m_front = type == front_cover_v;
+	}
+
+	[[nodiscard]] auto release() -> std::vector<std::byte> { return std::move(m_bytes); }
+
+  private:
+	static constexpr int front_cover_v{3};
+
+	std::vector<std::byte> m_bytes{};
+	bool m_front{};
+};
+
+// APIC: encoding, MIME type (null terminated), picture type, description (null terminated), data
+// PIC (2.2): encoding, 3 character image format, picture type, description, data
+void parse_id3v2_picture(PictureSelector& out, std::string_view const id, Bytes data) {
+	if (data.size() < 5) { return; }
+	auto const wide = std::to_integer<int>(data[0]) == 1 || std::to_integer<int>(data[0]) == 2;
+	if (id == "PIC") {
+		data = data.subspan(4);
+	} else {
+		auto const it = std::ranges::find(data.subspan(1), std::byte{});
+		if (it == data.end()) { return; }
+		data = data.subspan(std::size_t(it - data.begin()) + 1);
+	}
+	if (data.empty()) { return; }
+	auto const type = std::to_integer<int>(data[0]);
+	data = data.subspan(1);
+	auto const step = wide ? 2uz : 1uz;
+	for (std::size_t i = 0; i + step <= data.size(); i += step) {
+		if (data[i] != std::byte{} || (wide && data[i + 1] != std::byte{})) { continue; }
+		out.offer(type, data.subspan(i + step));
+		return;
+	}
+}
+
+void read_id3v2_pictures(PictureSelector& out, Bytes const tag) {
+	for_each_id3v2_frame(tag, [&out](std::string_view const id, Bytes const data) {
+		if (id == "APIC" || id == "PIC") { parse_id3v2_picture(out, id, data); }
+	});
+}
+
+// type, MIME type, description, width, height, depth, colours, data: lengths and numbers are 32 bit big endian
+void parse_flac_picture(PictureSelector& out, Bytes block) {
+	auto const skip_string = [&block] {
+		if (block.size() < 4) { return false; }
+		block = block.subspan(std::min<std::size_t>(4 + be(block, 0, 4), block.size()));
+		return true;
+	};
+	if (block.size() < 4) { return; }
+	auto const type = int(be(block, 0, 4));
+	block = block.subspan(4);
+	if (!skip_string() || !skip_string() || block.size() < 20) { return; }
+	auto const size = std::min<std::size_t>(be(block, 16, 4), block.size() - 20);
+	out.offer(type, block.subspan(20, size));
+}
+} // namespace
+
+auto read_tags(std::string const& path) -> std::optional<Tags> {
+	auto file = File{path};
+	if (!file) { return {}; }
+	auto ret = Tags{};
+	auto const offset = read_id3v2(file, 0, [&ret](Bytes const tag) { parse_id3v2(ret, tag); });
+	read_flac(ret, file, offset);
+	read_riff(ret, file);
+	read_id3v1(ret, file);
+	return ret;
+}
+
+auto read_cover_art(std::string const& path) -> std::vector<std::byte> {
+	auto file = File{path};
+	if (!file) { return {}; }
+	auto selector = PictureSelector{};
+	auto const offset = read_id3v2(file, 0, [&selector](Bytes const tag) { read_id3v2_pictures(selector, tag); });
+	for_each_flac_block(file, offset, [&](int const type, std::uint64_t const block, std::size_t const size) {
+		if (type == flac_picture_v) { parse_flac_picture(selector, file.read(block, size)); }
+		return !selector.is_done();
+	});
+	for_each_riff_chunk(file, [&](Bytes const chunk, std::uint64_t const offset, std::size_t const size) {
+		if (is_id3_chunk(chunk)) { read_id3v2_pictures(selector, file.read(offset, size)); }
+	});
+	return selector.release();
+}
+} // namespace riff
@@ -0,0 +1,15 @@
+#pragma once
+#include <tags.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace riff {
+// reads ID3v2 (2.2 - 2.4), FLAC VORBIS_COMMENT and RIFF LIST/INFO tags, with ID3v1 as a fallback.
+// only the tag regions of the file are read, frames are parsed in place and each field is converted once.
+[[nodiscard]] auto read_tags(std::string const& path) -> std::optional<Tags>;
+
+// embedded cover art in its encoded form (ID3v2 APIC/PIC, FLAC PICTURE): the front cover, else the first picture
+[[nodiscard]] auto read_cover_art(std::string const& path) -> std::vector<std::byte>;
+} // namespace riff
@@ -0,0 +1,44 @@
+#include <log.hpp>
+#include <tag_reader.hpp>
+#include <tag_scanner.hpp>
+#include <algorithm>
+
+namespace riff {
+TagScanner::TagScanner() {
+	auto const count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, max_threads_v);
+	for (std::size_t i = 0; i < count; ++i) {
+		m_threads.emplace_back([this](std::stop_token const& stop) { run(stop); });
+	}
+}
+
+void TagScanner::enqueue(std::string_view const path) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (!m_pending.emplace(path).second) { return; }
+	m_queue.emplace_back(path);
+	m_cv.notify_one();
+}
+
+void TagScanner::drain_to(std::vector<Result>& out) {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_results.empty()) { return; }
+	std::ranges::move(m_results, std::back_inserter(out));
+	m_results.clear();
+}
+
+void TagScanner::run(std::stop_token const& stop) {
+	while (!stop.stop_requested()) {
+		auto lock = std::unique_lock{m_mutex};
+		if (!m_cv.wait(lock, stop, [this] { return !m_queue.empty(); })) { return; }
+		auto path = std::move(m_queue.front());
+		m_queue.pop_front();
+		lock.unlock();
+
+		auto tags = read_tags(path);
+		if (!tags) { log.warn("failed to read tags: {}", path); }
+
+		lock.lock();
+		m_pending.erase(path);
+		m_results.push_back(Result{.path = std::move(path), .tags = tags.value_or(Tags{})});
+	}
+}
+} // namespace riff
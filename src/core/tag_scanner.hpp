@@ -0,0 +1,43 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <tags.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace riff {
+// Reads tags of enqueued files on a small pool of worker threads.
+class TagScanner : public klib::Pinned {
+  public:
+	struct Result {
+		std::string path{};
+		Tags tags{};
+	};
+
+	static constexpr std::size_t max_threads_v{4};
+
+	TagScanner();
+
+	void enqueue(std::string_view path);
+	void drain_to(std::vector<Result>& out);
+
+  private:
+	struct Hash : std::hash<std::string_view> {
+		using is_transparent = void;
+	};
+
+	void run(std::stop_token const& stop);
+
+	std::mutex m_mutex{};
+	std::condition_variable_any m_cv{};
+	std::deque<std::string> m_queue{};
+	std::unordered_set<std::string, Hash, std::equal_to<>> m_pending{};
+	std::vector<Result> m_results{};
+
+	std::vector<std::jthread> m_threads{};
+};
+} // namespace riff
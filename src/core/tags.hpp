@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <format>
+#include <string>
+
+namespace riff {
+struct Tags {
+	// "artist - title", empty without a title
+	[[nodiscard]] auto get_display_name() const -> std::string {
+		if (title.empty()) { return {}; }
+		if (artist.empty()) { return title; }
+		return std::format("{} - {}", artist, title);
+	}
+
+	std::string title{};
+	std::string artist{};
+	std::string album{};
+	std::uint32_t track_number{};
+
+	auto operator==(Tags const&) const -> bool = default;
+};
+} // namespace riff
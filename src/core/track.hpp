@@ -1,6 +1,9 @@
 #pragma once
+#include <loudness.hpp>
+#include <tags.hpp>
 #include <time.hpp>
 #include <cstdint>
+#include <optional>
 #include <string>
 
 namespace riff {
@@ -12,6 +15,11 @@ struct Track {
 	std::string label{};
 	std::string duration_label{};
 	Time duration{};
+	// size and last write time seen: to ignore watcher events that did not modify the file, and to match failures
+	std::uint64_t size{};
+	std::int64_t mtime{};
+	std::optional<ReplayGain> replay_gain{};
+	std::optional<Tags> tags{};
 	Status status{Status::None};
 };
 } // namespace riff
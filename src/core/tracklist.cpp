@@ -0,0 +1,184 @@
+#include <file_type.hpp>
+#include <playlist.hpp>
+#include <tracklist.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace riff {
+namespace {
+namespace fs = std::filesystem;
+
+[[nodiscard]] auto to_track(fs::path const& path, std::uint64_t& out_prev_id) {
+	auto ec = std::error_code{};
+	auto ret = Track{
+		.path = path.generic_string(),
+		.name = path.filename().generic_string(),
+		.size = fs::file_size(path, ec),
+		.mtime = fs::last_write_time(path, ec).time_since_epoch().count(),
+	};
+	ret.label = std::format("{}##{}", ret.name, ++out_prev_id);
+	return ret;
+}
+
+[[nodiscard]] auto can_open(std::string const& path) -> bool { return std::ifstream{path, std::ios::binary}.is_open(); }
+} // namespace
+
+auto Tracklist::has_playable_track() const -> bool {
+	return std::ranges::any_of(m_tracks, [](Track const& t) { return t.status != Track::Status::Error; });
+}
+
+auto Tracklist::has_next_track() const -> bool {
+	if (m_tracks.empty()) { return false; }
+	if (is_inactive()) { return true; }
+	if (!is_last()) { return true; }
+	return false;
+}
+
+auto Tracklist::push(std::string_view const path) -> bool {
+	auto const paths = std::array{std::string{path}};
+	return push(paths) == 0;
+}
+
+auto Tracklist::push(std::span<std::string const> const paths) -> std::size_t {
+	auto const types = sniff_file_types(paths);
+	auto ret = 0uz;
+	for (std::size_t i = 0; i < paths.size(); ++i) {
+		switch (types[i]) {
+		case FileType::Music: append_track(paths[i]); break;
+		case FileType::Playlist:
+			if (!append_playlist(paths[i])) { ++ret; }
+			break;
+		default: ++ret; break;
+		}
+	}
+	return ret;
+}
+
+void Tracklist::push_track(Track track) {
+	if (track.tags) {
+		if (auto name = track.tags->get_display_name(); !name.empty()) { track.name = std::move(name); }
+	}
+	track.label = std::format("{}##{}", track.name, ++m_prev_id);
+	m_tracks.push_back(std::move(track));
+}
+
+void Tracklist::set_tags(Track& track, Tags tags) {
+	auto name = tags.get_display_name();
+	track.tags = std::move(tags);
+	if (name.empty() || name == track.name) { return; }
+	auto const id = std::string_view{track.label}.substr(track.label.rfind("##"));
+	track.label = std::format("{}{}", name, id);
+	track.name = std::move(name);
+}
+
+void Tracklist::clear() {
+	m_tracks.clear();
+	m_active = m_cursor = m_tracks.end();
+}
+
+void Tracklist::shuffle() {
+	auto tracks = std::vector<Track>{};
+	tracks.reserve(m_tracks.size());
+	std::ranges::move(m_tracks, std::back_inserter(tracks));
+	std::ranges::shuffle(tracks, std::mt19937{std::random_device{}()});
+	m_tracks.clear();
+	std::ranges::move(tracks, std::back_inserter(m_tracks));
+	m_active = m_cursor = m_tracks.end();
+}
+
+void Tracklist::sort_by_tags() {
+	auto const no_tags = Tags{};
+	auto const key = [&no_tags](Track const& track) {
+		auto const& tags = track.tags ? *track.tags : no_tags;
+		return std::tie(tags.artist, tags.album, tags.track_number, track.name);
+	};
+	// list::sort relinks nodes: the cursor and active iterators stay valid
+	m_tracks.sort([&key](Track const& a, Track const& b) { return key(a) < key(b); });
+}
+
+auto Tracklist::save_playlist(std::string_view const path) const -> bool {
+	if (m_tracks.empty() || path.empty()) { return false; }
+	auto playlist = Playlist{};
+	playlist.paths.reserve(m_tracks.size());
+	for (auto const& track : m_tracks) { playlist.paths.push_back(track.path); }
+	return playlist.save_to(path);
+}
+
+auto Tracklist::peek_next() -> Track* {
+	if (m_tracks.empty()) { return nullptr; }
+	auto it = m_active;
+	for (std::size_t i = 0; i < m_tracks.size(); ++i) {
+		it = it == m_tracks.end() || std::next(it) == m_tracks.end() ? m_tracks.begin() : std::next(it);
+		if (it != m_active && it->status != Track::Status::Error) { return &*it; }
+	}
+	return nullptr;
+}
+
+auto Tracklist::cycle_next() -> Track* {
+	if (m_tracks.empty()) { return nullptr; }
+	if (is_inactive() || is_last()) {
+		m_active = m_tracks.begin();
+	} else {
+		++m_active;
+	}
+	return &*m_active;
+}
+
+auto Tracklist::cycle_prev() -> Track* {
+	if (m_tracks.empty()) { return nullptr; }
+	if (is_first()) { m_active = m_tracks.end(); }
+	--m_active;
+	return &*m_active;
+}
+
+auto Tracklist::is_inactive() const -> bool { return m_active == m_tracks.end(); }
+
+auto Tracklist::is_first() const -> bool { return m_active == m_tracks.begin(); }
+
+auto Tracklist::is_last() const -> bool {
+	assert(!is_inactive());
+	return std::next(m_active) == m_tracks.end();
+}
+
+auto Tracklist::append_playlist(std::string_view const path) -> bool {
+	auto playlist = Playlist{};
+	if (!playlist.append_from(path)) { return false; }
+	// readable entries that are not audio are dropped, nested playlists are not followed.
+	// missing / unreadable entries are kept as errors so that saving the playlist doesn't lose them.
+	auto const types = sniff_file_types(playlist.paths);
+	for (std::size_t i = 0; i < playlist.paths.size(); ++i) {
+		auto const& entry = playlist.paths[i];
+		if (types[i] == FileType::Music) {
+			append_track(entry);
+		} else if (!can_open(entry)) {
+			append_track(entry);
+			m_tracks.back().status = Track::Status::Error;
+		}
+	}
+	return true;
+}
+
+void Tracklist::append_track(std::string_view const path) {
+	auto const fs_path = fs::absolute(path);
+	m_tracks.push_back(to_track(fs_path, m_prev_id));
+}
+
+void Tracklist::swap_with_cursor(It const& it) {
+	assert(m_tracks.size() > 1 && m_cursor != m_tracks.end() && it != m_tracks.end());
+	if (m_active == it) {
+		m_active = m_cursor;
+	} else if (m_active == m_cursor) {
+		m_active = it;
+	}
+	std::swap(*m_cursor, *it);
+	m_cursor = it;
+}
+} // namespace riff
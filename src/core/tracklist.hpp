@@ -4,6 +4,8 @@
 #include <track.hpp>
 #include <cstdint>
 #include <list>
+#include <span>
+#include <string>
 
 namespace riff {
 class Tracklist : public klib::Pinned {
@@ -12,17 +14,39 @@ class Tracklist : public klib::Pinned {
 		virtual auto play_track(Track& track) -> bool = 0;
 		virtual void unload_active() = 0;
 		virtual void on_save() = 0;
+		// returns false if cover art is unavailable, else a size x size item was submitted
+		virtual auto draw_cover(Track const& track, float size) -> bool = 0;
 	};
 
 	[[nodiscard]] auto is_empty() const -> bool { return m_tracks.empty(); }
+	[[nodiscard]] auto get_size() const -> std::size_t { return m_tracks.size(); }
 	[[nodiscard]] auto has_playable_track() const -> bool;
 	[[nodiscard]] auto has_next_track() const -> bool;
 
+	// files are classified by content: anything that is neither audio nor a playlist is rejected before decoding
 	auto push(std::string_view path) -> bool;
+	// sniffs the batch in parallel, returns the number of paths rejected
+	auto push(std::span<std::string const> paths) -> std::size_t;
+	// path must be absolute, label is assigned here
+	void push_track(Track track);
+	// renames track after its tags, if they have a title
+	static void set_tags(Track& track, Tags tags);
 	void clear();
+	void shuffle();
+	// by artist, album, track number, then name
+	void sort_by_tags();
 
 	[[nodiscard]] auto save_playlist(std::string_view path) const -> bool;
 
+	[[nodiscard]] auto get_active() -> Track* { return is_inactive() ? nullptr : &*m_active; }
+
+	template <typename F>
+	void for_each_track(F func) {
+		for (auto& track : m_tracks) { func(track); }
+	}
+
+	// the first non-error track cycle_next() would reach, without moving: nullptr if there is none
+	[[nodiscard]] auto peek_next() -> Track*;
 	auto cycle_next() -> Track*;
 	auto cycle_prev() -> Track*;
 
@@ -41,6 +65,7 @@ class Tracklist : public klib::Pinned {
 	void remove_track(IMediator& mediator);
 	void move_track_up();
 	void move_track_down();
+	void sort_tracks();
 	void track_list(IMediator& mediator);
 	void swap_with_cursor(It const& it);
 
@@ -0,0 +1,105 @@
+#include <headless.hpp>
+#include <log.hpp>
+#include <atomic>
+#include <filesystem>
+#include <csignal>
+#include <thread>
+#include <unordered_map>
+
+namespace riff {
+namespace {
+std::atomic<bool> g_interrupted{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+extern "C" void on_interrupt(int /*signal*/) { g_interrupted = true; }
+} // namespace
+
+Headless::Headless(Params const& params) : m_params(params) {
+	m_config.path = m_params.config_path;
+	m_config.load_or_create();
+	m_config.watch();
+	auto const directory = std::filesystem::path{m_config.path}.parent_path();
+	m_loudness_scanner.path = (directory / "riff.loudness").generic_string();
+	m_loudness_scanner.load();
+
+	m_engine = capo::create_engine();
+	if (!m_engine) { throw std::runtime_error{"Failed to create Audio Engine"}; }
+	create_player();
+}
+
+auto Headless::run() -> int {
+	for (auto const& path : m_params.paths) {
+		if (!m_tracklist.push(path)) { log.warn("skipping non-music file: {}", path); }
+	}
+	if (!m_tracklist.has_playable_track()) {
+		log.error("nothing to play");
+		return EXIT_FAILURE;
+	}
+	if (m_params.shuffle) { m_tracklist.shuffle(); }
+	scan_loudness();
+
+	std::signal(SIGINT, &on_interrupt);
+	std::signal(SIGTERM, &on_interrupt);
+
+	m_playback->advance();
+	auto const* active = m_tracklist.get_active();
+	while (!g_interrupted && m_playback->is_playing()) {
+		std::this_thread::sleep_for(poll_interval_v);
+		if (m_config.poll_reload()) {
+			apply_config();
+			scan_loudness();
+		}
+		update_replay_gain();
+		m_playback->update();
+		if (auto const* track = m_tracklist.get_active(); track != active && track != nullptr) {
+			active = track;
+			log.info("playing: {}", active->path);
+		}
+	}
+
+	if (auto const latency = m_player->get_latency()) {
+		log.info("output latency: {:.1f}ms to start, cursor step {:.1f}ms", latency->start_ms, latency->step_ms);
+	}
+	m_player->unload_track();
+	return EXIT_SUCCESS;
+}
+
+void Headless::create_player() {
+	auto source = m_engine->create_source();
+	if (!source) { throw std::runtime_error{"Failed to create Audio Source"}; }
+
+	m_player.emplace(std::move(source));
+	apply_config();
+	m_playback.emplace(*m_player, m_tracklist);
+}
+
+void Headless::apply_config() {
+	m_player->set_volume(m_config.get_volume());
+	m_player->set_balance(m_config.get_balance());
+	m_player->set_repeat(m_config.get_repeat());
+	m_player->set_normalize(m_config.get_normalize());
+}
+
+// tracks measured in an earlier run (by App or Headless) are read back from the loudness cache, not decoded again
+void Headless::scan_loudness() {
+	if (m_player->get_normalize() == Normalize::Off) { return; }
+	m_tracklist.for_each_track([this](Track const& track) {
+		if (!track.replay_gain && track.status != Track::Status::Error) { m_loudness_scanner.enqueue(track.path); }
+	});
+}
+
+void Headless::update_replay_gain() {
+	m_loudness_results.clear();
+	m_loudness_scanner.drain_to(m_loudness_results);
+	if (m_loudness_results.empty()) { return; }
+	auto gains = std::unordered_map<std::string_view, ReplayGain>{};
+	for (auto const& result : m_loudness_results) {
+		for (auto const& track : result.tracks) {
+			gains.insert_or_assign(track.path, ReplayGain{.track_db = track.track_db, .album_db = result.album_db});
+		}
+	}
+	m_tracklist.for_each_track([&gains](Track& track) {
+		if (auto const it = gains.find(track.path); it != gains.end()) { track.replay_gain = it->second; }
+	});
+	if (auto const* active = m_tracklist.get_active()) { m_player->set_replay_gain(active->replay_gain); }
+}
+} // namespace riff
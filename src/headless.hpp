@@ -0,0 +1,35 @@
+#pragma once
+#include <capo/engine.hpp>
+#include <config.hpp>
+#include <loudness_scanner.hpp>
+#include <params.hpp>
+#include <playback.hpp>
+
+namespace riff {
+// Plays the tracks / playlists passed on the command line without a window or GL context.
+class Headless : public klib::Pinned {
+  public:
+	static constexpr auto poll_interval_v{20ms};
+
+	explicit Headless(Params const& params);
+
+	auto run() -> int;
+
+  private:
+	void create_player();
+	void apply_config();
+	void scan_loudness();
+	void update_replay_gain();
+
+	Params m_params{};
+	Config m_config{};
+	std::unique_ptr<capo::IEngine> m_engine{};
+	std::optional<Player> m_player{};
+
+	Tracklist m_tracklist{};
+	std::optional<Playback> m_playback{};
+
+	LoudnessScanner m_loudness_scanner{};
+	std::vector<LoudnessScanner::Result> m_loudness_results{};
+};
+} // namespace riff
@@ -1,6 +1,8 @@
 #include <app.hpp>
 #include <build_version.hpp>
+#include <headless.hpp>
 #include <klib/args/parse.hpp>
+#include <profiler.hpp>
 #include <array>
 #include <print>
 
@@ -13,12 +15,32 @@ auto main(int argc, char** argv) -> int {
 		};
 		auto const args = std::array{
 			klib::args::named_option(params.config_path, "config", "path to riff config file"),
+			klib::args::named_flag(params.headless, "headless", "play without a window"),
+			klib::args::named_flag(params.shuffle, "shuffle", "shuffle tracks before playing (headless)"),
+			klib::args::named_option(params.trace_path, "trace", "record a Chrome trace of profiler zones to this path"),
+			klib::args::positional_list(params.paths, "paths", "tracks / playlists to play (headless)"),
 		};
 		auto const parse_result = klib::args::parse_main(app_info, args, argc, argv);
 		if (parse_result.early_return()) { return parse_result.get_return_code(); }
 
-		auto app = riff::App{params};
-		app.run();
+		auto& profiler = riff::Profiler::self();
+		if (!params.trace_path.empty()) {
+			profiler.trace_path = params.trace_path;
+			profiler.start_trace();
+		}
+
+		auto ret = EXIT_SUCCESS;
+		if (params.headless) {
+			auto headless = riff::Headless{params};
+			ret = headless.run();
+		} else {
+			auto app = riff::App{params};
+			app.run();
+		}
+
+		if (profiler.is_tracing()) { profiler.stop_trace(profiler.trace_path); }
+		if constexpr (riff::Profiler::enabled_v) { profiler.log_load_reports(); }
+		return ret;
 	} catch (std::exception const& e) {
 		std::println("PANIC: {}", e.what());
 		return EXIT_FAILURE;
@@ -0,0 +1,14 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace riff {
+struct Params {
+	std::string_view config_path{"riff.conf"};
+	bool headless{};
+	bool shuffle{};
+	std::string_view trace_path{};
+	std::vector<std::string> paths{};
+};
+} // namespace riff
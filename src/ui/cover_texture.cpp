@@ -0,0 +1,71 @@
+#include <imgui_internal.h>
+#include <cover_texture.hpp>
+#include <algorithm>
+
+namespace riff {
+#if IMGUI_VERSION_NUM >= 19200
+namespace {
+void queue_upload(ImTextureData& texture, ImTextureRect const& rect) {
+	if (texture.Status != ImTextureStatus_OK && texture.Status != ImTextureStatus_WantUpdates) { return; }
+	if (texture.Status == ImTextureStatus_OK) {
+		texture.Updates.resize(0);
+		texture.UpdateRect = rect;
+	} else {
+		auto& bounds = texture.UpdateRect;
+		auto const x1 = std::max(bounds.x + bounds.w, rect.x + rect.w);
+		auto const y1 = std::max(bounds.y + bounds.h, rect.y + rect.h);
+		bounds.x = std::min(bounds.x, rect.x);
+		bounds.y = std::min(bounds.y, rect.y);
+		bounds.w = static_cast<unsigned short>(x1 - bounds.x);
+		bounds.h = static_cast<unsigned short>(y1 - bounds.y);
+	}
+	texture.Updates.push_back(rect);
+	texture.SetStatus(ImTextureStatus_WantUpdates);
+}
+} // namespace
+
+CoverTexture::~CoverTexture() {
+	if (m_registered && ImGui::GetCurrentContext() != nullptr) { ImGui::UnregisterUserTexture(&m_texture); }
+}
+
+void CoverTexture::update(CoverAtlas& atlas) {
+	static constexpr auto extent_v = int(CoverAtlas::extent_v);
+	static constexpr auto cell_v = static_cast<unsigned short>(CoverAtlas::cell_size_v);
+	m_dirty.clear();
+	atlas.drain_dirty_to(m_dirty);
+	if (!m_registered) {
+		m_texture.Create(ImTextureFormat_RGBA32, extent_v, extent_v);
+		ImGui::RegisterUserTexture(&m_texture);
+		m_registered = true;
+		m_dirty.clear();
+		std::ranges::copy(atlas.get_pixels(), static_cast<std::uint8_t*>(m_texture.GetPixels()));
+		return;
+	}
+
+	auto const pixels = atlas.get_pixels();
+	static constexpr auto row_size_v = std::size_t(CoverAtlas::cell_size_v) * 4;
+	for (auto const& cell : m_dirty) {
+		for (std::uint32_t y = 0; y < CoverAtlas::cell_size_v; ++y) {
+			auto const offset = (std::size_t(cell.y + y) * CoverAtlas::extent_v + cell.x) * 4;
+			std::copy_n(pixels.data() + offset, row_size_v, static_cast<std::uint8_t*>(m_texture.GetPixels()) + offset);
+		}
+		auto const x = static_cast<unsigned short>(cell.x);
+		auto const y = static_cast<unsigned short>(cell.y);
+		queue_upload(m_texture, ImTextureRect{.x = x, .y = y, .w = cell_v, .h = cell_v});
+	}
+}
+
+void CoverTexture::draw(CoverAtlas::Region const& region, float const size) {
+	ImGui::Image(m_texture.GetTexRef(), {size, size}, {region.u0, region.v0}, {region.u1, region.v1});
+}
+#else
+CoverTexture::~CoverTexture() = default;
+
+void CoverTexture::update(CoverAtlas& atlas) {
+	m_dirty.clear();
+	atlas.drain_dirty_to(m_dirty);
+}
+
+void CoverTexture::draw(CoverAtlas::Region const& /*region*/, float const size) { ImGui::Dummy({size, size}); }
+#endif
+} // namespace riff
@@ -0,0 +1,31 @@
+#pragma once
+#include <klib/base_types.hpp>
+#include <cover_atlas.hpp>
+#include <imgui.h>
+#include <vector>
+
+namespace riff {
+// Mirrors a CoverAtlas into one ImGui managed texture: the renderer backend creates it once and then receives
+// only the cells written since the previous frame. Requires ImGui 1.92 (ImTextureData), otherwise nothing is drawn.
+class CoverTexture : public klib::Pinned {
+  public:
+#if IMGUI_VERSION_NUM >= 19200
+	static constexpr bool supported_v{true};
+#else
+	static constexpr bool supported_v{false};
+#endif
+
+	CoverTexture() = default;
+	~CoverTexture();
+
+	void update(CoverAtlas& atlas);
+	void draw(CoverAtlas::Region const& region, float size);
+
+  private:
+	std::vector<CoverAtlas::Cell> m_dirty{};
+#if IMGUI_VERSION_NUM >= 19200
+	ImTextureData m_texture{};
+	bool m_registered{};
+#endif
+};
+} // namespace riff
@@ -0,0 +1,20 @@
+#include <imgui.h>
+#include <playback.hpp>
+#include <profiler.hpp>
+
+namespace riff {
+void Playback::update_frame(Player::IMediator& player_mediator, Tracklist::IMediator& tracklist_mediator) {
+	update();
+	{
+		RIFF_PROFILE_ZONE(PlayerUpdate);
+		m_player->update(player_mediator);
+	}
+
+	ImGui::Separator();
+	ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 5.0f);
+	{
+		RIFF_PROFILE_ZONE(TracklistRender);
+		m_tracklist->update(tracklist_mediator);
+	}
+}
+} // namespace riff
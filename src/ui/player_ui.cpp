@@ -5,8 +5,8 @@
 #include <klib/enum_array.hpp>
 #include <player.hpp>
 #include <util.hpp>
-#include <cassert>
-#include <utility>
+#include <algorithm>
+#include <cmath>
 
 namespace riff {
 namespace {
@@ -17,57 +17,29 @@ constexpr auto repeat_icon_v = klib::EnumArray<Repeat, klib::CString>{
 	ICON_KI_MOVE_RL_ALT,
 	ICON_KI_STICK_MOVE_RL_ALT,
 };
-} // namespace
-
-Player::Player(std::unique_ptr<capo::ISource> source) : m_source(std::move(source)) {
-	assert(m_source);
-	m_cursor_str = duration_0_str;
-	m_duration_str = duration_0_str.c_str();
-}
-
-void Player::set_repeat(Repeat const repeat) {
-	m_repeat = repeat;
-	m_source->set_looping(m_repeat == Repeat::One);
-}
-
-auto Player::load_track(Track& track) -> bool {
-	auto const was_playing = is_playing();
-	if (!m_source->open_file_stream(track.path.c_str())) {
-		track.status = Track::Status::Error;
-		return false;
-	}
-
-	track.status = Track::Status::Ok;
-	track.duration = m_source->get_duration();
-	track.duration_label.clear();
-	capo::format_duration_to(track.duration_label, track.duration);
-
-	m_title = track.name.c_str();
-	m_duration_str = track.duration_label.c_str();
-	m_seeking = false;
-
-	if (was_playing) { play(); }
-	return true;
-}
-
-void Player::unload_track() {
-	m_source->unbind();
 
-	m_title = blank_title_v.data();
-	m_duration_str = duration_0_str.c_str();
-	m_seeking = false;
+// drawn in the active button colour while on
+auto toggle_button(char const* label, bool const on, ImVec2 const size) -> bool {
+	if (on) { ImGui::PushStyleColor(ImGuiCol_Button, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive)); }
+	auto const ret = ImGui::ButtonEx(label, size);
+	if (on) { ImGui::PopStyleColor(); }
+	return ret;
 }
+} // namespace
 
 void Player::update(IMediator& mediator) {
 	if (!m_seeking) { m_cursor = std::max(m_source->get_cursor().count(), 0.0f); }
 	m_cursor_str.clear();
 	capo::format_duration_to(m_cursor_str, Time{m_cursor});
+	if (m_tap.is_enabled()) { m_tap.update(m_source->get_cursor(), m_source->is_playing()); }
 
+	if (mediator.draw_active_cover(ImGui::GetTextLineHeight())) { ImGui::SameLine(); }
 	ImGui::TextUnformatted(m_title.c_str());
 	ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 5.0f);
 	buttons(mediator);
 	sliders();
 	seekbar();
+	if (m_spectrum.is_enabled()) { spectrum(); }
 }
 
 void Player::buttons(IMediator& mediator) {
@@ -75,13 +47,13 @@ void Player::buttons(IMediator& mediator) {
 	if (!m_source->is_bound()) { ImGui::BeginDisabled(); }
 	if (ImGui::ButtonEx(m_source->is_playing() ? ICON_KI_PAUSE : ICON_KI_CARET_RIGHT, {50.0f, 50.0f})) {
 		if (m_source->is_playing()) {
-			m_source->stop();
+			pause();
 		} else {
-			m_source->play();
+			play();
 		}
 	}
 
-	enum class Action : std::int8_t { None, Previous, Next };
+	enum class Action : std::int8_t { None, Previous, Next, Library };
 	auto action = Action::None;
 
 	ImGui::SameLine();
@@ -96,11 +68,20 @@ void Player::buttons(IMediator& mediator) {
 	if (ImGui::ButtonEx(repeat_icon.c_str(), {30.0f, 30.0f})) {
 		set_repeat(Repeat((int(m_repeat) + 1) % int(Repeat::COUNT_)));
 	}
+	ImGui::SameLine();
+	if (ImGui::ButtonEx("LIB", {35.0f, 30.0f})) { action = Action::Library; }
+	ImGui::SameLine();
+	if (toggle_button("VU", m_show_meters, {30.0f, 30.0f})) { set_show_meters(!m_show_meters); }
+	if (ImGui::IsItemHovered()) { ImGui::SetTooltip("level meters"); }
+	ImGui::SameLine();
+	if (toggle_button("FFT", get_show_spectrum(), {35.0f, 30.0f})) { set_show_spectrum(!get_show_spectrum()); }
+	if (ImGui::IsItemHovered()) { ImGui::SetTooltip("spectrum"); }
 
 	switch (action) {
 	case Action::None: break;
 	case Action::Previous: mediator.skip_prev(); break;
 	case Action::Next: mediator.skip_next(); break;
+	case Action::Library: mediator.open_library(); break;
 	}
 }
 
@@ -125,10 +106,9 @@ void Player::sliders() {
 	ImGui::SameLine();
 	ImGui::SetCursorPosY(ImGui::GetCursorPosY() - (0.2f * volume_icon_size.y));
 	ImGui::SetNextItemWidth(volume_width_v);
-	auto volume = int(m_source->get_gain() * 100.0f);
-	if (ImGui::SliderInt("##volume", &volume, 0, 100, "%d", ImGuiSliderFlags_ClampZeroRange)) {
-		m_source->set_gain(float(volume) * 0.01f);
-	}
+	auto volume = m_volume;
+	if (ImGui::SliderInt("##volume", &volume, 0, 100, "%d", ImGuiSliderFlags_ClampZeroRange)) { set_volume(volume); }
+	if (m_show_meters) { meters(); }
 	ImGui::SetCursorPosY(ImGui::GetCursorPosY() + (0.2f * volume_icon_size.y));
 }
 
@@ -139,6 +119,12 @@ void Player::seekbar() {
 	ImGui::SameLine();
 	util::align_right(duration_width);
 	ImGui::TextUnformatted(m_duration_str.c_str());
+	if (ImGui::IsItemHovered()) {
+		if (auto const latency = get_latency()) {
+			ImGui::SetTooltip("output latency: %.1f ms to start, cursor step %.1f ms", double(latency->start_ms),
+							  double(latency->step_ms));
+		}
+	}
 
 	auto fduration = std::max(m_source->get_duration().count(), 0.0f);
 	if (fduration == 0.0f) { ImGui::BeginDisabled(); }
@@ -151,4 +137,37 @@ void Player::seekbar() {
 	if (was_seeking && !m_seeking) { m_source->set_cursor(Time{m_cursor}); }
 	if (fduration == 0.0f) { ImGui::EndDisabled(); }
 }
+
+// drawn into the item spacing under the volume slider, so toggling the meters does not shift the layout
+void Player::meters() {
+	static constexpr auto floor_db_v = -60.0f;
+	static constexpr auto to_fraction = [](float const level) {
+		if (level <= 0.0f) { return 0.0f; }
+		return std::clamp((20.0f * std::log10(level) - floor_db_v) / -floor_db_v, 0.0f, 1.0f);
+	};
+
+	auto const channels = std::min(m_meter.get_channels(), std::uint8_t(2));
+	if (channels == 0) { return; }
+	auto const min = ImGui::GetItemRectMin();
+	auto const max = ImGui::GetItemRectMax();
+	auto const height = std::max(ImGui::GetStyle().ItemSpacing.y / float(channels), 1.0f);
+	auto const width = max.x - min.x;
+	auto& draw_list = *ImGui::GetWindowDrawList();
+	for (std::size_t c = 0; c < channels; ++c) {
+		auto const level = m_meter.get_level(c);
+		auto const top = max.y + (float(c) * height);
+		auto const rms_x = min.x + (width * to_fraction(level.rms));
+		auto const peak_x = min.x + (width * to_fraction(level.peak));
+		draw_list.AddRectFilled({min.x, top}, {rms_x, top + height}, ImGui::GetColorU32(ImGuiCol_PlotHistogram));
+		draw_list.AddLine({peak_x, top}, {peak_x, top + height}, ImGui::GetColorU32(ImGuiCol_PlotLines));
+	}
+}
+
+void Player::spectrum() {
+	static constexpr auto height_v = 60.0f;
+	auto bands = std::array<float, Spectrum::bands_v>{};
+	m_spectrum.copy_bands(bands);
+	auto const size = ImVec2{ImGui::GetContentRegionAvail().x, height_v};
+	ImGui::PlotHistogram("##spectrum", bands.data(), int(bands.size()), 0, nullptr, 0.0f, 1.0f, size);
+}
 } // namespace riff
@@ -0,0 +1,97 @@
+#include <imgui.h>
+#include <profiler.hpp>
+#include <algorithm>
+#include <array>
+#include <format>
+
+namespace riff {
+namespace {
+void load_reports() {
+	auto const reports = Profiler::self().get_load_reports();
+	if (reports.empty()) {
+		ImGui::TextUnformatted("no track loads yet");
+		return;
+	}
+	using Stage = Profiler::LoadStage;
+	static constexpr auto columns_v = 3 + int(Stage::COUNT_) - 1;
+	static constexpr auto flags_v = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+	if (!ImGui::BeginTable("first_audio", columns_v, flags_v)) { return; }
+	ImGui::TableSetupColumn("format/location");
+	ImGui::TableSetupColumn("p50 ms");
+	ImGui::TableSetupColumn("p99 ms");
+	for (auto stage = Stage::PlayTrack; stage < Stage::COUNT_; stage = Stage(int(stage) + 1)) {
+		ImGui::TableSetupColumn(Profiler::load_stage_name_v[stage].data());
+	}
+	ImGui::TableHeadersRow();
+	for (auto const& report : reports) {
+		ImGui::TableNextRow();
+		ImGui::TableNextColumn();
+		ImGui::Text("%s (%zu)", report.key.c_str(), report.count);
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", double(report.p50));
+		ImGui::TableNextColumn();
+		ImGui::Text("%.1f", double(report.p99));
+		for (auto stage = Stage::PlayTrack; stage < Stage::COUNT_; stage = Stage(int(stage) + 1)) {
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", double(report.stage_p50.at(std::size_t(stage))));
+		}
+	}
+	ImGui::EndTable();
+}
+} // namespace
+
+void Profiler::update(bool& open) {
+	static constexpr auto flags_v = ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing;
+	ImGui::SetNextWindowBgAlpha(0.85f);
+	if (!ImGui::Begin("Profiler", &open, flags_v)) {
+		ImGui::End();
+		return;
+	}
+
+	if constexpr (!enabled_v) {
+		ImGui::TextUnformatted("profiling is compiled out of this build");
+		ImGui::End();
+		return;
+	}
+
+	auto history = std::array<float, window_v>{};
+	copy_history(Zone::Frame, history);
+	auto const frame = get_stats(Zone::Frame);
+	auto const overlay = std::format("{:.2f} ms (max {:.2f})", frame.mean, frame.max);
+	ImGui::PlotHistogram("##frames", history.data(), int(history.size()), 0, overlay.c_str(), 0.0f,
+						 std::max(frame.max, 1000.0f / 60.0f), {360.0f, 60.0f});
+
+	static constexpr auto table_flags_v = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+	if (ImGui::BeginTable("zones", 4, table_flags_v)) {
+		ImGui::TableSetupColumn("zone");
+		ImGui::TableSetupColumn("last ms");
+		ImGui::TableSetupColumn("mean ms");
+		ImGui::TableSetupColumn("max ms");
+		ImGui::TableHeadersRow();
+		for (auto zone = Zone::PlayerUpdate; zone < Zone::COUNT_; zone = Zone(int(zone) + 1)) {
+			auto const stats = get_stats(zone);
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(zone_name_v[zone].data());
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", double(stats.last));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", double(stats.mean));
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", double(stats.max));
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImGui::CollapsingHeader("Time to first audio")) { load_reports(); }
+
+	if (is_tracing()) {
+		if (ImGui::Button("Stop trace")) { stop_trace(trace_path); }
+		ImGui::SameLine();
+		ImGui::TextUnformatted("recording...");
+	} else if (ImGui::Button("Record trace")) {
+		start_trace();
+	}
+	ImGui::End();
+}
+} // namespace riff
@@ -0,0 +1,93 @@
+#include <IconsKenney.h>
+#include <imgui.h>
+#include <profiler.hpp>
+#include <tracklist.hpp>
+#include <util.hpp>
+#include <cassert>
+
+namespace riff {
+void Tracklist::update(IMediator& mediator) {
+	ImGui::TextUnformatted(ICON_KI_LIST);
+	auto const none_selected = m_cursor == m_tracks.end();
+	if (none_selected) { ImGui::BeginDisabled(); }
+	ImGui::SameLine();
+	remove_track(mediator);
+	ImGui::SameLine();
+	move_track_up();
+	ImGui::SameLine();
+	move_track_down();
+	if (none_selected) { ImGui::EndDisabled(); }
+	auto const is_empty = m_tracks.empty();
+	if (is_empty) { ImGui::BeginDisabled(); }
+	ImGui::SameLine();
+	if (ImGui::Button(ICON_KI_SAVE)) { mediator.on_save(); }
+	ImGui::SameLine();
+	sort_tracks();
+	if (is_empty) { ImGui::EndDisabled(); }
+	track_list(mediator);
+}
+
+void Tracklist::remove_track(IMediator& mediator) {
+	if (ImGui::Button(ICON_KI_TIMES)) {
+		if (m_active == m_cursor) {
+			mediator.unload_active();
+			m_active = m_tracks.end();
+		}
+		m_cursor = m_tracks.erase(m_cursor);
+	}
+}
+
+void Tracklist::move_track_up() {
+	auto const on_first_track = is_first();
+	if (on_first_track) { ImGui::BeginDisabled(); }
+	if (ImGui::Button(ICON_KI_ARROW_TOP)) { swap_with_cursor(std::prev(m_cursor)); }
+	if (on_first_track) { ImGui::EndDisabled(); }
+}
+
+void Tracklist::move_track_down() {
+	auto const on_last_track = !is_inactive() && is_last();
+	if (on_last_track) { ImGui::BeginDisabled(); }
+	if (ImGui::Button(ICON_KI_ARROW_BOTTOM)) { swap_with_cursor(std::next(m_cursor)); }
+	if (on_last_track) { ImGui::EndDisabled(); }
+}
+
+void Tracklist::sort_tracks() {
+	if (ImGui::Button(ICON_KI_SORT)) { sort_by_tags(); }
+}
+
+void Tracklist::track_list(IMediator& mediator) {
+	auto switch_track = false;
+	ImGui::BeginChild("Tracklist", {}, ImGuiChildFlags_Borders);
+	for (auto it = m_tracks.begin(); it != m_tracks.end(); ++it) {
+		auto const& track = *it;
+		auto const is_now_playing = m_active == it;
+		auto const is_error = track.status == Track::Status::Error;
+		if (is_error) {
+			ImGui::PushStyleColor(ImGuiCol_Text, ImVec4{1.0f, 0.3f, 0.0f, 1.0f});
+		} else if (is_now_playing) {
+			ImGui::PushStyleColor(ImGuiCol_Text, ImVec4{0.5f, 1.0f, 0.2f, 1.0f});
+		}
+		auto const cover_size = ImGui::GetTextLineHeight();
+		if (ImGui::IsRectVisible({cover_size, cover_size}) && mediator.draw_cover(track, cover_size)) {
+			ImGui::SameLine();
+		}
+		auto const is_selected = m_cursor == it;
+		if (ImGui::Selectable(track.label.c_str(), is_selected)) { m_cursor = it; }
+		if (is_now_playing || is_error) { ImGui::PopStyleColor(); }
+		if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) { switch_track = true; }
+		if (track.status == Track::Status::Ok) {
+			ImGui::SameLine();
+			auto const width = ImGui::CalcTextSize(track.duration_label.c_str()).x;
+			util::align_right(width);
+			ImGui::TextUnformatted(track.duration_label.c_str());
+		}
+	}
+	ImGui::EndChild();
+
+	if (switch_track) {
+		RIFF_PROFILE_LOAD(Click);
+		auto& track = *m_cursor;
+		m_active = mediator.play_track(track) ? m_cursor : m_tracks.end();
+	}
+}
+} // namespace riff
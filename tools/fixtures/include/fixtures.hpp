@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace riff::fixtures {
+enum class Format : std::int8_t { Wav, Flac, Mp3 };
+
+struct Signal {
+	float duration{5.0f}; // seconds
+	std::uint32_t sample_rate{44100};
+	std::uint8_t channels{2};
+	std::uint8_t bits{16}; // 16 or 24
+	std::uint32_t seed{42};
+};
+
+// deterministic interleaved PCM: a distinct tone per channel over low level noise
+[[nodiscard]] auto generate(Signal const& signal) -> std::vector<std::int32_t>;
+
+[[nodiscard]] auto encode_wav(Signal const& signal, std::span<std::int32_t const> samples) -> std::vector<std::byte>;
+// uncompressed (verbatim subframe) FLAC
+[[nodiscard]] auto encode_flac(Signal const& signal, std::span<std::int32_t const> samples) -> std::vector<std::byte>;
+// MPEG-1 Layer III frames with empty main data: decodes to silence of the requested length
+[[nodiscard]] auto encode_mp3(Signal const& signal) -> std::vector<std::byte>;
+
+[[nodiscard]] auto encode(Format format, Signal const& signal) -> std::vector<std::byte>;
+
+[[nodiscard]] auto get_extension(Format format) -> std::string_view;
+
+struct Written {
+	std::filesystem::path path{};
+	bool valid{};
+};
+
+// writes valid fixtures for each format, plus truncated, corrupt, empty and misnamed files
+auto write_all(std::filesystem::path const& directory, Signal const& signal) -> std::vector<Written>;
+} // namespace riff::fixtures
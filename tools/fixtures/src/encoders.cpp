@@ -0,0 +1,228 @@
+#include <fixtures.hpp>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <random>
+
+namespace riff::fixtures {
+namespace {
+class ByteWriter {
+  public:
+	void bytes(std::string_view const str) {
+		for (auto const c : str) { m_out.push_back(std::byte(c)); }
+	}
+
+	// little endian
+	template <std::unsigned_integral Type>
+	void le(Type const value, std::size_t const size = sizeof(Type)) {
+		for (std::size_t i = 0; i < size; ++i) { m_out.push_back(std::byte((value >> (8 * i)) & 0xff)); }
+	}
+
+	// big endian, bit granular
+	void bits(std::uint64_t const value, int const count) {
+		for (int i = count - 1; i >= 0; --i) {
+			m_acc = std::uint8_t((m_acc << 1) | ((value >> i) & 1));
+			if (++m_acc_bits == 8) {
+				m_out.push_back(std::byte(m_acc));
+				m_acc = 0;
+				m_acc_bits = 0;
+			}
+		}
+	}
+
+	void align() {
+		if (m_acc_bits > 0) { bits(0, 8 - m_acc_bits); }
+	}
+
+	[[nodiscard]] auto size() const -> std::size_t { return m_out.size(); }
+	[[nodiscard]] auto view(std::size_t const offset) const -> std::span<std::byte const> {
+		return std::span{m_out}.subspan(offset);
+	}
+	[[nodiscard]] auto release() -> std::vector<std::byte> { return std::move(m_out); }
+
+  private:
+	std::vector<std::byte> m_out{};
+	std::uint8_t m_acc{};
+	int m_acc_bits{};
+};
+
+[[nodiscard]] auto crc8(std::span<std::byte const> const bytes) {
+	auto ret = std::uint8_t{};
+	for (auto const b : bytes) {
+		ret ^= std::uint8_t(b);
+		for (int i = 0; i < 8; ++i) { ret = std::uint8_t((ret & 0x80) != 0 ? (ret << 1) ^ 0x07 : ret << 1); }
+	}
+	return ret;
+}
+
+[[nodiscard]] auto crc16(std::span<std::byte const> const bytes) {
+	auto ret = std::uint16_t{};
+	for (auto const b : bytes) {
+		ret ^= std::uint16_t(std::uint16_t(b) << 8);
+		for (int i = 0; i < 8; ++i) { ret = std::uint16_t((ret & 0x8000) != 0 ? (ret << 1) ^ 0x8005 : ret << 1); }
+	}
+	return ret;
+}
+
+// FLAC "UTF-8" coded frame number
+void write_coded_number(ByteWriter& out, std::uint32_t const value) {
+	if (value < 0x80) {
+		out.bits(value, 8);
+		return;
+	}
+	auto continuation = 1;
+	while (value >= (1u << ((5 * continuation) + 6))) { ++continuation; }
+	auto const lead_mask = std::uint32_t(0xff00 >> (continuation + 1)) & 0xff;
+	out.bits(lead_mask | (value >> (6 * continuation)), 8);
+	for (int i = continuation - 1; i >= 0; --i) { out.bits(0x80 | ((value >> (6 * i)) & 0x3f), 8); }
+}
+
+[[nodiscard]] constexpr auto get_frames(Signal const& signal) {
+	return std::size_t(double(signal.duration) * double(signal.sample_rate));
+}
+} // namespace
+
+auto generate(Signal const& signal) -> std::vector<std::int32_t> {
+	assert(signal.channels > 0 && (signal.bits == 16 || signal.bits == 24));
+	auto const frames = get_frames(signal);
+	auto const full_scale = double((1 << (signal.bits - 1)) - 1);
+	// minstd output is specified by the standard, distributions are not: map raw values for reproducibility
+	auto rng = std::minstd_rand{signal.seed};
+	auto ret = std::vector<std::int32_t>{};
+	ret.reserve(frames * signal.channels);
+	for (std::size_t f = 0; f < frames; ++f) {
+		auto const t = double(f) / double(signal.sample_rate);
+		for (std::uint8_t c = 0; c < signal.channels; ++c) {
+			auto const tone = 0.4 * std::sin(2.0 * std::numbers::pi * 220.0 * double(c + 2) * t);
+			auto const noise = 0.01 * ((double(rng()) / double(std::minstd_rand::max())) - 0.5);
+			ret.push_back(std::int32_t(std::lround((tone + noise) * full_scale)));
+		}
+	}
+	return ret;
+}
+
+auto encode_wav(Signal const& signal, std::span<std::int32_t const> const samples) -> std::vector<std::byte> {
+	auto const bytes_per_sample = std::uint32_t(signal.bits / 8);
+	auto const data_size = std::uint32_t(samples.size() * bytes_per_sample);
+	auto const block_align = std::uint16_t(signal.channels * bytes_per_sample);
+	auto out = ByteWriter{};
+	out.bytes("RIFF");
+	out.le(std::uint32_t(36 + data_size));
+	out.bytes("WAVEfmt ");
+	out.le(std::uint32_t{16});
+	out.le(std::uint16_t{1}); // PCM
+	out.le(std::uint16_t{signal.channels});
+	out.le(signal.sample_rate);
+	out.le(std::uint32_t(signal.sample_rate * block_align));
+	out.le(block_align);
+	out.le(std::uint16_t{signal.bits});
+	out.bytes("data");
+	out.le(data_size);
+	for (auto const sample : samples) { out.le(std::uint32_t(sample), bytes_per_sample); }
+	return out.release();
+}
+
+auto encode_flac(Signal const& signal, std::span<std::int32_t const> const samples) -> std::vector<std::byte> {
+	static constexpr auto block_size_v = std::size_t{4096};
+	auto const frames = samples.size() / signal.channels;
+	auto out = ByteWriter{};
+	out.bytes("fLaC");
+
+	// STREAMINFO, last metadata block; frame sizes and MD5 left as unknown (0)
+	out.bits(1, 1);
+	out.bits(0, 7);
+	out.bits(34, 24);
+	out.bits(block_size_v, 16);
+	out.bits(block_size_v, 16);
+	out.bits(0, 24);
+	out.bits(0, 24);
+	out.bits(signal.sample_rate, 20);
+	out.bits(signal.channels - 1u, 3);
+	out.bits(signal.bits - 1u, 5);
+	out.bits(frames, 36);
+	for (int i = 0; i < 16; ++i) { out.bits(0, 8); }
+
+	auto const sample_size_code = signal.bits == 24 ? 0b110 : 0b100;
+	auto frame_number = std::uint32_t{};
+	for (std::size_t first = 0; first < frames; first += block_size_v, ++frame_number) {
+		auto const block = std::min(block_size_v, frames - first);
+		auto const frame_start = out.size();
+		out.bits(0b11111111111110, 14);
+		out.bits(0, 1);		 // reserved
+		out.bits(0, 1);		 // fixed block size
+		out.bits(0b0111, 4); // block size: 16 bits at end of header
+		out.bits(0b0000, 4); // sample rate: from STREAMINFO
+		out.bits(signal.channels - 1u, 4);
+		out.bits(std::uint64_t(sample_size_code), 3);
+		out.bits(0, 1);
+		write_coded_number(out, frame_number);
+		out.bits(block - 1, 16);
+		out.bits(crc8(out.view(frame_start)), 8);
+
+		for (std::uint8_t c = 0; c < signal.channels; ++c) {
+			out.bits(0b00000010, 8); // VERBATIM, no wasted bits
+			for (std::size_t f = first; f < first + block; ++f) {
+				auto const sample = samples[(f * signal.channels) + c];
+				out.bits(std::uint64_t(std::uint32_t(sample)) & ((1ull << signal.bits) - 1), signal.bits);
+			}
+		}
+		out.align();
+		out.bits(crc16(out.view(frame_start)), 16);
+	}
+	return out.release();
+}
+
+auto encode_mp3(Signal const& signal) -> std::vector<std::byte> {
+	static constexpr auto bitrate_v = std::uint32_t{128'000};
+	static constexpr auto samples_per_frame_v = std::size_t{1152};
+	auto rate_index = std::uint8_t{};
+	auto sample_rate = signal.sample_rate;
+	switch (sample_rate) {
+	case 48000: rate_index = 1; break;
+	case 32000: rate_index = 2; break;
+	default: sample_rate = 44100; break;
+	}
+	auto const mono = signal.channels == 1;
+	auto const side_info_size = mono ? std::size_t{17} : std::size_t{32};
+	auto const frame_size = std::size_t(144 * bitrate_v / sample_rate);
+	auto const frames = (std::size_t(double(signal.duration) * double(sample_rate)) + samples_per_frame_v - 1) /
+						samples_per_frame_v;
+
+	assert(frame_size > 4 + side_info_size);
+
+	auto out = std::vector<std::byte>{};
+	out.reserve(frames * frame_size);
+	for (std::size_t i = 0; i < frames; ++i) {
+		auto const header = std::array{
+			std::byte{0xff},
+			std::byte{0xfb}, // MPEG-1, Layer III, no CRC
+			std::byte(0x90 | (rate_index << 2)), // 128 kbps, no padding
+			std::byte(mono ? 0xc0 : 0x00),
+		};
+		out.insert(out.end(), header.begin(), header.end());
+		// zeroed side info: part2_3_length 0 for every granule
+		out.resize(out.size() + frame_size - header.size(), std::byte{});
+	}
+	return out;
+}
+
+auto encode(Format const format, Signal const& signal) -> std::vector<std::byte> {
+	switch (format) {
+	case Format::Wav: return encode_wav(signal, generate(signal));
+	case Format::Flac: return encode_flac(signal, generate(signal));
+	case Format::Mp3: return encode_mp3(signal);
+	}
+	return {};
+}
+
+auto get_extension(Format const format) -> std::string_view {
+	switch (format) {
+	case Format::Wav: return ".wav";
+	case Format::Flac: return ".flac";
+	case Format::Mp3: return ".mp3";
+	}
+	return {};
+}
+} // namespace riff::fixtures
@@ -0,0 +1,69 @@
+#include <fixtures.hpp>
+#include <format>
+#include <fstream>
+#include <random>
+
+namespace riff::fixtures {
+namespace {
+namespace fs = std::filesystem;
+
+auto write_file(fs::path const& path, std::span<std::byte const> const bytes) -> bool {
+	auto file = std::ofstream{path, std::ios::binary};
+	if (!file.is_open()) { return false; }
+	file.write(reinterpret_cast<char const*>(bytes.data()), std::streamsize(bytes.size())); // NOLINT
+	return file.good();
+}
+
+[[nodiscard]] auto truncate(std::vector<std::byte> bytes) {
+	bytes.resize(bytes.size() * 3 / 5);
+	return bytes;
+}
+
+[[nodiscard]] auto garbage(std::string_view const magic, std::size_t const size, std::uint32_t const seed) {
+	auto ret = std::vector<std::byte>{};
+	ret.reserve(size);
+	for (auto const c : magic) { ret.push_back(std::byte(c)); }
+	auto rng = std::minstd_rand{seed};
+	while (ret.size() < size) { ret.push_back(std::byte(rng() & 0xff)); }
+	return ret;
+}
+} // namespace
+
+auto write_all(fs::path const& directory, Signal const& signal) -> std::vector<Written> {
+	auto ret = std::vector<Written>{};
+	auto err = std::error_code{};
+	fs::create_directories(directory, err);
+	auto const push = [&](std::string_view const filename, std::span<std::byte const> const bytes, bool const valid) {
+		auto path = directory / filename;
+		if (write_file(path, bytes)) { ret.push_back(Written{.path = std::move(path), .valid = valid}); }
+	};
+
+	auto const stem = std::format("tone_{}hz_{}ch_{}bit", signal.sample_rate, signal.channels, signal.bits);
+	auto const samples = generate(signal);
+	auto const wav = encode_wav(signal, samples);
+	auto const flac = encode_flac(signal, samples);
+	auto const mp3 = encode_mp3(signal);
+
+	push(stem + ".wav", wav, true);
+	push(stem + ".flac", flac, true);
+	push(stem + ".mp3", mp3, true);
+
+	push("truncated.wav", truncate(wav), false);
+	push("truncated.flac", truncate(flac), false);
+	push("truncated.mp3", truncate(mp3), false);
+
+	auto bad_header = wav;
+	bad_header.at(20) = std::byte{0x34}; // audio format tag
+	bad_header.at(21) = std::byte{0x12};
+	push("bad_header.wav", bad_header, false);
+	push("garbage.flac", garbage("fLaC", 64 * 1024, signal.seed), false);
+	push("garbage.mp3", garbage("ID3", 64 * 1024, signal.seed + 1), false);
+	push("empty.wav", {}, false);
+
+	// valid content under the wrong extension
+	push("wav_named.mp3", wav, true);
+	push("flac_named.wav", flac, true);
+
+	return ret;
+}
+} // namespace riff::fixtures
@@ -0,0 +1,45 @@
+#include <build_version.hpp>
+#include <fixtures.hpp>
+#include <klib/args/parse.hpp>
+#include <array>
+#include <print>
+
+auto main(int argc, char** argv) -> int {
+	try {
+		auto signal = riff::fixtures::Signal{};
+		auto channels = int(signal.channels);
+		auto bits = int(signal.bits);
+		auto out_dir = std::string_view{"fixtures"};
+		auto const app_info = klib::args::ParseInfo{
+			.help_text = "riff-fixtures: generate deterministic audio fixtures",
+			.version = riff::build_version_str,
+		};
+		auto const args = std::array{
+			klib::args::named_option(out_dir, "out", "output directory"),
+			klib::args::named_option(signal.duration, "duration", "length in seconds"),
+			klib::args::named_option(signal.sample_rate, "rate", "sample rate"),
+			klib::args::named_option(channels, "channels", "channel count (1-8)"),
+			klib::args::named_option(bits, "bits", "bits per sample (16 or 24)"),
+			klib::args::named_option(signal.seed, "seed", "noise seed"),
+		};
+		auto const parse_result = klib::args::parse_main(app_info, args, argc, argv);
+		if (parse_result.early_return()) { return parse_result.get_return_code(); }
+
+		if (channels < 1 || channels > 8 || (bits != 16 && bits != 24) || signal.sample_rate == 0) {
+			std::println("invalid signal: {} channels, {} bits, {} Hz", channels, bits, signal.sample_rate);
+			return EXIT_FAILURE;
+		}
+		signal.channels = std::uint8_t(channels);
+		signal.bits = std::uint8_t(bits);
+
+		for (auto const& written : riff::fixtures::write_all(out_dir, signal)) {
+			std::println("{} {}", written.valid ? "[valid]  " : "[corrupt]", written.path.generic_string());
+		}
+	} catch (std::exception const& e) {
+		std::println("PANIC: {}", e.what());
+		return EXIT_FAILURE;
+	} catch (...) {
+		std::println("PANIC!");
+		return EXIT_FAILURE;
+	}
+}